@@ -0,0 +1,45 @@
+#include <iostream>
+#include <chrono>
+#include "neural_network.h"
+#include "dense.h"
+#include "activation.h"
+
+using namespace utec::nn;
+
+// Compara memoria pico de activaciones y tiempo por epoca segun el
+// tamano de segmento del checkpointing (0 = sin checkpointing).
+int main() {
+    const size_t batch = 256, width = 64, depth = 16, epochs = 20;
+
+    Tensor2<float> X(batch, width);
+    Tensor2<float> Y(batch, 1);
+    for (size_t i = 0; i < batch; ++i) {
+        for (size_t j = 0; j < width; ++j)
+            X(i, j) = float((i * 31 + j * 17) % 97) / 97.0f;
+        Y(i, 0) = float(i % 2);
+    }
+
+    std::cout << "segmento, pico_activaciones_KB, ms_por_epoca\n";
+    for (size_t segment : {0, 2, 4, 8, 16}) {
+        NeuralNetwork<float> net;
+        for (size_t d = 0; d < depth; ++d) {
+            net.add_layer(std::make_unique<Dense<float>>(width, width));
+            net.add_layer(std::make_unique<ReLU<float>>());
+        }
+        net.add_layer(std::make_unique<Dense<float>>(width, 1));
+        net.enable_checkpointing(segment);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t e = 0; e < epochs; ++e) {
+            net.backward(net.forward(X), Y);
+            net.optimize(0.001f);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> ms = end - start;
+
+        std::cout << segment << ", "
+                  << net.peak_activation_bytes() / 1024 << ", "
+                  << ms.count() / epochs << "\n";
+    }
+    return 0;
+}
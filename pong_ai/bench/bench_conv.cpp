@@ -0,0 +1,47 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include "conv.h"
+#include "EnvGym.h"
+
+using namespace utec::nn;
+using utec::agent::State;
+
+// Throughput del renderizado de frames y de Conv2D (im2col vs Winograd)
+// sobre lotes de observaciones en pixeles.
+int main() {
+    const size_t batch = 32, H = 64, W = 64, reps = 10;
+    using clock = std::chrono::high_resolution_clock;
+
+    Tensor4<float> frames(batch, 1, H, W);
+    auto start = clock::now();
+    for (size_t r = 0; r < reps; ++r) {
+        for (size_t n = 0; n < batch; ++n) {
+            State s{float(n) / batch, float((n * 7) % batch) / batch, 0.5f};
+            render_frame(s, frames.begin() + n * H * W, H, W);
+        }
+    }
+    std::chrono::duration<double> t = clock::now() - start;
+    std::cout << "render: " << (batch * reps) / t.count() << " frames/s\n";
+
+    std::cout << "capa, algoritmo, ms_forward, imagenes/s\n";
+    struct Caso { size_t in_c, out_c; };
+    for (Caso c : {Caso{1, 16}, Caso{16, 32}}) {
+        Tensor4<float> x(batch, c.in_c, H, W);
+        size_t i = 0;
+        for (auto& v : x) v = float(i++ % 13) / 13.0f;
+        for (ConvAlgo algo : {ConvAlgo::Im2col, ConvAlgo::Winograd}) {
+            Conv2D<float> conv(c.in_c, H, W, c.out_c, 3, 1, 1, algo);
+            conv.forward(x);
+            auto t0 = clock::now();
+            for (size_t r = 0; r < reps; ++r)
+                conv.forward(x);
+            std::chrono::duration<double, std::milli> ms = clock::now() - t0;
+            std::cout << c.in_c << "->" << c.out_c << ", "
+                      << (algo == ConvAlgo::Im2col ? "im2col" : "winograd") << ", "
+                      << ms.count() / reps << ", "
+                      << batch * reps / (ms.count() / 1000.0) << "\n";
+        }
+    }
+    return 0;
+}
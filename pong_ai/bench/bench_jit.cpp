@@ -0,0 +1,68 @@
+#include <iostream>
+#include <chrono>
+#include "neural_network.h"
+#include "activation.h"
+#include "codegen.h"
+#include "PongAgent.h"
+#include "CompiledPolicy.h"
+
+using namespace utec::nn;
+using utec::agent::PongAgent;
+using utec::agent::State;
+
+// Latencia de inferencia de la red interpretada (Tensor + ILayer) frente a
+// la misma red compilada con CompiledNetwork, por decision de PongAgent y
+// por lotes.
+int main() {
+    using clock = std::chrono::high_resolution_clock;
+    const int decisiones = 100000, reps = 200;
+
+    std::cout << "red, modo, batch, us_por_fila, speedup\n";
+    for (size_t oculta : {16, 64, 128}) {
+        NeuralNetwork<float> net;
+        net.add_layer(std::make_unique<Dense<float>>(3, oculta));
+        net.add_layer(std::make_unique<ReLU<float>>());
+        net.add_layer(std::make_unique<Dense<float>>(oculta, oculta));
+        net.add_layer(std::make_unique<ReLU<float>>());
+        net.add_layer(std::make_unique<Dense<float>>(oculta, 1));
+
+        auto start = clock::now();
+        CompiledNetwork<float> jit(net);
+        std::chrono::duration<double, std::milli> compilar = clock::now() - start;
+        std::string nombre = "3-" + std::to_string(oculta) + "-" + std::to_string(oculta) + "-1";
+        std::cerr << nombre << ": compilacion " << compilar.count() << " ms\n";
+
+        PongAgent<float> interpretado(net), compilado(utec::agent::compiled_policy(jit, 3));
+        int suma = 0;
+        start = clock::now();
+        for (int i = 0; i < decisiones; ++i)
+            suma += interpretado.act(State{float(i % 97) / 97, float(i % 89) / 89, 0.5f});
+        std::chrono::duration<double, std::micro> base = clock::now() - start;
+        start = clock::now();
+        for (int i = 0; i < decisiones; ++i)
+            suma -= compilado.act(State{float(i % 97) / 97, float(i % 89) / 89, 0.5f});
+        std::chrono::duration<double, std::micro> t = clock::now() - start;
+        if (suma != 0) std::cerr << "las decisiones no coinciden\n";
+        std::cout << nombre << ", act, 1, " << base.count() / decisiones << ", 1\n";
+        std::cout << nombre << ", act_jit, 1, " << t.count() / decisiones << ", "
+                  << base.count() / t.count() << "\n";
+
+        for (size_t batch : {64, 1024}) {
+            Tensor2<float> X(batch, 3);
+            for (size_t i = 0; i < batch; ++i)
+                for (size_t k = 0; k < 3; ++k)
+                    X(i, k) = float((i * 7 + k * 13) % 29) / 29.0f;
+            start = clock::now();
+            for (int r = 0; r < reps; ++r) net.forward(X);
+            std::chrono::duration<double, std::micro> b = clock::now() - start;
+            start = clock::now();
+            for (int r = 0; r < reps; ++r) jit.forward(X);
+            std::chrono::duration<double, std::micro> j = clock::now() - start;
+            double filas = double(reps) * batch;
+            std::cout << nombre << ", forward, " << batch << ", " << b.count() / filas << ", 1\n";
+            std::cout << nombre << ", forward_jit, " << batch << ", " << j.count() / filas << ", "
+                      << b.count() / j.count() << "\n";
+        }
+    }
+    return 0;
+}
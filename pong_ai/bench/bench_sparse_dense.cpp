@@ -0,0 +1,47 @@
+#include <iostream>
+#include <chrono>
+#include "dense.h"
+#include "sparse_dense.h"
+
+using namespace utec::nn;
+
+template<typename Layer>
+double ms_forward_backward(Layer& layer, const Tensor2<float>& X, const Tensor2<float>& G, int reps) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        layer.forward(X);
+        layer.backward(G);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> ms = end - start;
+    return ms.count() / reps;
+}
+
+// Speedup de SparseDense frente a Dense segun el nivel de poda.
+int main() {
+    const size_t in = 1024, out = 1024, batch = 64;
+    const int reps = 5;
+
+    Tensor2<float> X(batch, in), G(batch, out);
+    for (size_t i = 0; i < batch; ++i) {
+        for (size_t k = 0; k < in; ++k)
+            X(i, k) = float((i * 13 + k * 7) % 23) / 23.0f;
+        for (size_t j = 0; j < out; ++j)
+            G(i, j) = float((i + j) % 5) / 5.0f - 0.4f;
+    }
+
+    Dense<float> dense(in, out);
+    double base = ms_forward_backward(dense, X, G, reps);
+    std::cout << "modo, sparsity, ms_fwd_bwd, speedup\n";
+    std::cout << "dense, 0, " << base << ", 1\n";
+
+    for (float sparsity : {0.5f, 0.75f, 0.9f, 0.95f, 0.99f}) {
+        SparseDense<float> sparse(dense, PruneMode::Magnitude, sparsity);
+        double t = ms_forward_backward(sparse, X, G, reps);
+        std::cout << "magnitude, " << sparsity << ", " << t << ", " << base / t << "\n";
+    }
+    SparseDense<float> s24(dense, PruneMode::Structured2of4);
+    double t = ms_forward_backward(s24, X, G, reps);
+    std::cout << "2:4, 0.5, " << t << ", " << base / t << "\n";
+    return 0;
+}
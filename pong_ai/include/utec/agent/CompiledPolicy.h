@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+#include "codegen.h"
+#include "PongAgent.h"
+
+namespace utec {
+    namespace agent {
+
+        // Adaptador opcional (requiere POSIX: dlopen y un compilador en tiempo
+        // de ejecucion): PongAgent<T> agent(compiled_policy(net, 3)).
+        // `net` debe vivir mas que el agente. Se puede llamar desde varios
+        // hilos a la vez: la salida va a un buffer propio de cada hilo.
+        template<typename T>
+        typename PongAgent<T>::Policy compiled_policy(const nn::CompiledNetwork<T>& net, size_t in_features) {
+            if (net.in_features() != in_features)
+                throw algebra::TensorError("compiled_policy: compiled network input does not match observation");
+            size_t n = net.out_features();
+            return [&net, n](const T* x) {
+                thread_local std::vector<T> salida;
+                salida.resize(n);
+                net.run(x, salida.data());
+                return salida[0];
+            };
+        }
+
+    } // namespace agent
+} // namespace utec
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <algorithm>
 
 namespace utec {
     namespace agent {
@@ -9,11 +11,46 @@ namespace utec {
             float paddle_y;
         };
 
+        enum class ObservationMode {
+            Features,  // (ball_x, ball_y, paddle_y)
+            Pixels     // frame de 1 canal renderizado desde el estado
+        };
+
+        // Dibuja el estado (coordenadas normalizadas en [0, 1]) en un frame
+        // alto x ancho en escala de grises: pelota de 2x2 y paleta en la
+        // columna izquierda con alto de un quinto del frame.
+        inline void render_frame(const State& s, float* frame, size_t height, size_t width) {
+            std::fill(frame, frame + height * width, 0.0f);
+            if (height == 0 || width == 0) return;
+            auto a_pixel = [](float v, size_t n) {
+                long p = static_cast<long>(v * static_cast<float>(n));
+                return static_cast<size_t>(std::clamp<long>(p, 0, static_cast<long>(n) - 1));
+            };
+
+            size_t alto_paleta = std::max<size_t>(1, height / 5);
+            size_t centro = a_pixel(s.paddle_y, height);
+            size_t y0 = centro >= alto_paleta / 2 ? centro - alto_paleta / 2 : 0;
+            size_t y1 = std::min(height, y0 + alto_paleta);
+            for (size_t y = y0; y < y1; ++y)
+                frame[y * width] = 1.0f;
+
+            size_t bx = a_pixel(s.ball_x, width), by = a_pixel(s.ball_y, height);
+            for (size_t y = by; y < std::min(height, by + 2); ++y)
+                for (size_t x = bx; x < std::min(width, bx + 2); ++x)
+                    frame[y * width + x] = 1.0f;
+        }
+
         class EnvGym {
         public:
             virtual ~EnvGym() = default;
             virtual State reset() = 0;
             virtual State step(int action, float &reward, bool &done) = 0;
+
+            // Observacion en pixeles del estado; los entornos con su propio
+            // renderer pueden sobreescribirla.
+            virtual void render(const State& s, float* frame, size_t height, size_t width) const {
+                render_frame(s, frame, height, width);
+            }
         };
 
     } // namespace agent
@@ -1,5 +1,9 @@
 #pragma once
+#include <vector>
+#include <functional>
+#include <type_traits>
 #include "Tensor.h"
+#include "Random.h"
 #include "neural_network.h"
 #include "activation.h"
 #include "layer.h"
@@ -13,23 +17,92 @@ namespace utec {
         template<typename T>
         class PongAgent {
         public:
+            // Cualquier evaluador de la red: recibe la observacion (3 valores o
+            // frame_h * frame_w pixeles) y devuelve la primera salida
+            using Policy = std::function<T(const T* observation)>;
+
             explicit PongAgent(const nn::NeuralNetwork<T>& model)
-              : model_(model) {}
+              : PongAgent(desde_modelo(model, 3)) {}
+
+            // En modo Pixels la red recibe un frame (1, frame_h * frame_w)
+            PongAgent(const nn::NeuralNetwork<T>& model, ObservationMode mode,
+                      size_t frame_h, size_t frame_w)
+              : PongAgent(desde_modelo(model, tamano(mode, frame_h, frame_w)), mode, frame_h, frame_w) {}
+
+            // Modo Pixels con los frames de env.render(): el agente ve lo
+            // mismo que produce un entorno con su propio renderer
+            PongAgent(const nn::NeuralNetwork<T>& model, const EnvGym& env,
+                      size_t frame_h, size_t frame_w)
+              : PongAgent(desde_modelo(model, frame_h * frame_w), env, frame_h, frame_w) {}
+
+            explicit PongAgent(Policy policy)
+              : policy_(std::move(policy)) {}
+
+            PongAgent(Policy policy, ObservationMode mode, size_t frame_h, size_t frame_w)
+              : policy_(std::move(policy)), mode_(mode), frame_h_(frame_h), frame_w_(frame_w) {}
 
+            PongAgent(Policy policy, const EnvGym& env, size_t frame_h, size_t frame_w)
+              : PongAgent(std::move(policy), ObservationMode::Pixels, frame_h, frame_w)
+            {
+                env_ = &env;
+            }
+
+            // La observacion se arma en buffers locales: act() no escribe
+            // estado del agente.
             int act(const State& s) const {
-                algebra::Tensor<T, 2> input(1, 3);
-                input(0, 0) = static_cast<T>(s.ball_x);
-                input(0, 1) = static_cast<T>(s.ball_y);
-                input(0, 2) = static_cast<T>(s.paddle_y);
-                auto out = model_.forward(input);
-                T v = out(0, 0);
+                if (mode_ == ObservationMode::Pixels) {
+                    std::vector<float> frame(frame_h_ * frame_w_);
+                    if (env_)
+                        env_->render(s, frame.data(), frame_h_, frame_w_);
+                    else
+                        render_frame(s, frame.data(), frame_h_, frame_w_);
+                    if constexpr (std::is_same<T, float>::value) {
+                        return decidir(policy_(frame.data()));
+                    } else {
+                        std::vector<T> obs(frame.begin(), frame.end());
+                        return decidir(policy_(obs.data()));
+                    }
+                }
+                T obs[3] = {static_cast<T>(s.ball_x), static_cast<T>(s.ball_y), static_cast<T>(s.paddle_y)};
+                return decidir(policy_(obs));
+            }
+
+            // Epsilon-greedy reproducible: la decision del paso `step` depende
+            // solo de (seed, step), asi varios entornos pueden muestrear en
+            // paralelo sin compartir un generador. Eso exige que la Policy
+            // tambien admita llamadas concurrentes: compiled_policy si, pero
+            // la que se arma desde un NeuralNetwork no, porque forward()
+            // escribe las caches de sus capas.
+            int sample(const State& s, uint64_t step, float epsilon, uint64_t seed = 7) const {
+                algebra::CounterRNG rng(seed);
+                if (rng.uniform(2 * step) < epsilon)
+                    return static_cast<int>(rng.bits(2 * step + 1) % 3) - 1;
+                return act(s);
+            }
+
+        private:
+            static int decidir(T v) {
                 if (v > T(0.5)) return +1;
                 if (v < T(-0.5)) return -1;
                 return 0;
             }
 
-        private:
-            const nn::NeuralNetwork<T>& model_;
+            static size_t tamano(ObservationMode mode, size_t frame_h, size_t frame_w) {
+                return mode == ObservationMode::Pixels ? frame_h * frame_w : 3;
+            }
+
+            static Policy desde_modelo(const nn::NeuralNetwork<T>& model, size_t n) {
+                return [&model, n](const T* x) {
+                    algebra::Tensor<T, 2> input(1, n);
+                    std::copy(x, x + n, input.begin());
+                    return model.forward(input)(0, 0);
+                };
+            }
+
+            Policy policy_;
+            const EnvGym* env_ = nullptr;
+            ObservationMode mode_ = ObservationMode::Features;
+            size_t frame_h_ = 0, frame_w_ = 0;
         };
 
     } // namespace agent
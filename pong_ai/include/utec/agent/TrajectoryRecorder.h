@@ -0,0 +1,331 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "Tensor.h"
+#include "EnvGym.h"
+
+namespace utec {
+    namespace agent {
+
+        class TrajectoryError : public std::exception {
+            std::string mensaje;
+        public:
+            TrajectoryError(std::string m) : mensaje(std::move(m)) {}
+            const char* what() const noexcept override { return mensaje.c_str(); }
+        };
+
+        // Formato en disco (little endian, tipos nativos):
+        //   cabecera: "PTRJ" + uint32 version
+        //   bloque:   uint32 filas, y por cada columna uint32 bytes + datos
+        // Columnas: ball_x, ball_y, paddle_y, reward (float), action (int8), done (uint8).
+        // Los float se guardan como XOR con el valor anterior, separados por
+        // planos de bytes y comprimidos con RLE: valores que cambian poco entre
+        // pasos dejan los bytes altos en cero y se comprimen bien.
+        struct TrajectoryCodec {
+            static constexpr uint32_t VERSION = 1;
+            static constexpr unsigned long COLUMNAS = 6;
+
+            // RLE tipo PackBits: control < 128 -> (control + 1) bytes literales,
+            // control >= 128 -> el siguiente byte repetido (control - 125) veces.
+            static void rle_encode(const uint8_t* in, size_t n, std::vector<uint8_t>& out) {
+                size_t i = 0;
+                while (i < n) {
+                    size_t run = 1;
+                    while (i + run < n && run < 130 && in[i + run] == in[i]) ++run;
+                    if (run >= 3) {
+                        out.push_back(static_cast<uint8_t>(run + 125));
+                        out.push_back(in[i]);
+                        i += run;
+                        continue;
+                    }
+                    size_t inicio = i;
+                    while (i < n && i - inicio < 128) {
+                        if (i + 2 < n && in[i] == in[i + 1] && in[i] == in[i + 2]) break;
+                        ++i;
+                    }
+                    out.push_back(static_cast<uint8_t>(i - inicio - 1));
+                    out.insert(out.end(), in + inicio, in + i);
+                }
+            }
+
+            static void rle_decode(const uint8_t* in, size_t n, uint8_t* out, size_t esperado) {
+                size_t i = 0, o = 0;
+                while (i < n) {
+                    uint8_t c = in[i++];
+                    if (c < 128) {
+                        size_t len = size_t(c) + 1;
+                        if (i + len > n || o + len > esperado)
+                            throw TrajectoryError("Corrupted trajectory chunk");
+                        std::memcpy(out + o, in + i, len);
+                        i += len;
+                        o += len;
+                    } else {
+                        size_t len = size_t(c) - 125;
+                        if (i >= n || o + len > esperado)
+                            throw TrajectoryError("Corrupted trajectory chunk");
+                        std::memset(out + o, in[i++], len);
+                        o += len;
+                    }
+                }
+                if (o != esperado)
+                    throw TrajectoryError("Corrupted trajectory chunk");
+            }
+
+            static std::vector<uint8_t> encode_floats(const std::vector<float>& v) {
+                size_t n = v.size();
+                std::vector<uint8_t> planos(n * 4);
+                uint32_t prev = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint32_t bits;
+                    std::memcpy(&bits, &v[i], 4);
+                    uint32_t x = bits ^ prev;
+                    prev = bits;
+                    for (size_t b = 0; b < 4; ++b)
+                        planos[b * n + i] = static_cast<uint8_t>(x >> (8 * b));
+                }
+                std::vector<uint8_t> out;
+                rle_encode(planos.data(), planos.size(), out);
+                return out;
+            }
+
+            static void decode_floats(const std::vector<uint8_t>& in, size_t n, float* out) {
+                std::vector<uint8_t> planos(n * 4);
+                rle_decode(in.data(), in.size(), planos.data(), planos.size());
+                uint32_t prev = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint32_t x = 0;
+                    for (size_t b = 0; b < 4; ++b)
+                        x |= uint32_t(planos[b * n + i]) << (8 * b);
+                    prev ^= x;
+                    std::memcpy(out + i, &prev, 4);
+                }
+            }
+        };
+
+        // Graba (estado, accion, recompensa, done) por bloques de columnas.
+        // record() solo copia a memoria; la compresion y la escritura las hace
+        // un hilo de fondo, asi el bucle del entorno nunca espera por disco.
+        class TrajectoryRecorder {
+        public:
+            explicit TrajectoryRecorder(const std::string& path, size_t chunk_rows = 4096)
+              : archivo(path, std::ios::binary), filas_bloque(chunk_rows)
+            {
+                if (!archivo)
+                    throw TrajectoryError("Cannot open trajectory file: " + path);
+                if (filas_bloque == 0)
+                    throw TrajectoryError("chunk_rows must be positive");
+                archivo.write("PTRJ", 4);
+                escribir_u32(TrajectoryCodec::VERSION);
+                actual.reservar(filas_bloque);
+                escritor = std::thread([this] { bucle_escritor(); });
+            }
+
+            TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+            TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+            ~TrajectoryRecorder() {
+                try {
+                    close();
+                } catch (...) {
+                }
+            }
+
+            void record(const State& s, int action, float reward, bool done) {
+                actual.ball_x.push_back(s.ball_x);
+                actual.ball_y.push_back(s.ball_y);
+                actual.paddle_y.push_back(s.paddle_y);
+                actual.reward.push_back(reward);
+                actual.action.push_back(static_cast<int8_t>(action));
+                actual.done.push_back(done ? 1 : 0);
+                if (actual.filas() >= filas_bloque)
+                    flush();
+            }
+
+            // Envia el bloque parcial al hilo escritor (no espera a que se escriba)
+            void flush() {
+                if (actual.filas() == 0) return;
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    pendientes.push_back(std::move(actual));
+                }
+                cv.notify_one();
+                actual = Bloque();
+                actual.reservar(filas_bloque);
+            }
+
+            // Escribe lo pendiente y cierra el archivo. Relanza errores de E/S.
+            void close() {
+                if (!escritor.joinable()) return;
+                flush();
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    cerrar = true;
+                }
+                cv.notify_one();
+                escritor.join();
+                archivo.close();
+                if (error)
+                    std::rethrow_exception(error);
+            }
+
+        private:
+            struct Bloque {
+                std::vector<float> ball_x, ball_y, paddle_y, reward;
+                std::vector<int8_t> action;
+                std::vector<uint8_t> done;
+
+                size_t filas() const { return ball_x.size(); }
+
+                void reservar(size_t n) {
+                    ball_x.reserve(n); ball_y.reserve(n); paddle_y.reserve(n);
+                    reward.reserve(n); action.reserve(n); done.reserve(n);
+                }
+            };
+
+            void bucle_escritor() {
+                while (true) {
+                    Bloque b;
+                    {
+                        std::unique_lock<std::mutex> lock(mtx);
+                        cv.wait(lock, [this] { return cerrar || !pendientes.empty(); });
+                        if (pendientes.empty()) return;
+                        b = std::move(pendientes.front());
+                        pendientes.pop_front();
+                    }
+                    if (error) continue;
+                    try {
+                        escribir_bloque(b);
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+
+            void escribir_bloque(const Bloque& b) {
+                escribir_u32(static_cast<uint32_t>(b.filas()));
+                escribir_columna(TrajectoryCodec::encode_floats(b.ball_x));
+                escribir_columna(TrajectoryCodec::encode_floats(b.ball_y));
+                escribir_columna(TrajectoryCodec::encode_floats(b.paddle_y));
+                escribir_columna(TrajectoryCodec::encode_floats(b.reward));
+                std::vector<uint8_t> col;
+                TrajectoryCodec::rle_encode(reinterpret_cast<const uint8_t*>(b.action.data()), b.action.size(), col);
+                escribir_columna(col);
+                col.clear();
+                TrajectoryCodec::rle_encode(b.done.data(), b.done.size(), col);
+                escribir_columna(col);
+                if (!archivo)
+                    throw TrajectoryError("Error writing trajectory file");
+            }
+
+            void escribir_columna(const std::vector<uint8_t>& col) {
+                escribir_u32(static_cast<uint32_t>(col.size()));
+                archivo.write(reinterpret_cast<const char*>(col.data()), col.size());
+            }
+
+            void escribir_u32(uint32_t v) {
+                archivo.write(reinterpret_cast<const char*>(&v), 4);
+            }
+
+            std::ofstream archivo;
+            size_t filas_bloque;
+            Bloque actual;
+            std::deque<Bloque> pendientes;
+            std::mutex mtx;
+            std::condition_variable cv;
+            bool cerrar = false;
+            std::exception_ptr error;
+            std::thread escritor;
+        };
+
+        // Lee un archivo de TrajectoryRecorder bloque a bloque, decodificando
+        // cada columna directamente en los tensores de entrenamiento.
+        class TrajectoryReader {
+        public:
+            explicit TrajectoryReader(const std::string& path)
+              : archivo(path, std::ios::binary)
+            {
+                if (!archivo)
+                    throw TrajectoryError("Cannot open trajectory file: " + path);
+                char magic[4];
+                archivo.read(magic, 4);
+                uint32_t version = 0;
+                if (!archivo || std::memcmp(magic, "PTRJ", 4) != 0 || !leer_u32(version))
+                    throw TrajectoryError("Not a trajectory file: " + path);
+                if (version != TrajectoryCodec::VERSION)
+                    throw TrajectoryError("Unsupported trajectory version");
+            }
+
+            // states: (n, 3) como la entrada de PongAgent; actions, rewards y
+            // dones: (n, 1). Devuelve false al llegar al final del archivo;
+            // un bloque cortado, aunque sea en su cabecera, es un error.
+            template<typename T>
+            bool next_chunk(algebra::Tensor<T, 2>& states, algebra::Tensor<T, 2>& actions,
+                            algebra::Tensor<T, 2>& rewards, algebra::Tensor<T, 2>& dones) {
+                uint32_t filas = 0;
+                archivo.read(reinterpret_cast<char*>(&filas), 4);
+                if (archivo.gcount() == 0)
+                    return false;
+                if (archivo.gcount() != 4)
+                    throw TrajectoryError("Truncated trajectory chunk");
+                size_t n = filas;
+
+                std::vector<float> cols[4];
+                for (auto& c : cols) {
+                    c.resize(n);
+                    TrajectoryCodec::decode_floats(leer_columna(), n, c.data());
+                }
+                std::vector<uint8_t> accion(n), fin(n);
+                auto raw = leer_columna();
+                TrajectoryCodec::rle_decode(raw.data(), raw.size(), accion.data(), n);
+                raw = leer_columna();
+                TrajectoryCodec::rle_decode(raw.data(), raw.size(), fin.data(), n);
+
+                states = algebra::Tensor<T, 2>(n, 3);
+                actions = algebra::Tensor<T, 2>(n, 1);
+                rewards = algebra::Tensor<T, 2>(n, 1);
+                dones = algebra::Tensor<T, 2>(n, 1);
+                T* s = states.begin();
+                T* a = actions.begin();
+                T* r = rewards.begin();
+                T* d = dones.begin();
+                for (size_t i = 0; i < n; ++i) {
+                    s[i * 3 + 0] = static_cast<T>(cols[0][i]);
+                    s[i * 3 + 1] = static_cast<T>(cols[1][i]);
+                    s[i * 3 + 2] = static_cast<T>(cols[2][i]);
+                    r[i] = static_cast<T>(cols[3][i]);
+                    a[i] = static_cast<T>(static_cast<int8_t>(accion[i]));
+                    d[i] = static_cast<T>(fin[i]);
+                }
+                return true;
+            }
+
+        private:
+            bool leer_u32(uint32_t& v) {
+                archivo.read(reinterpret_cast<char*>(&v), 4);
+                return archivo.gcount() == 4;
+            }
+
+            std::vector<uint8_t> leer_columna() {
+                uint32_t bytes = 0;
+                if (!leer_u32(bytes))
+                    throw TrajectoryError("Truncated trajectory chunk");
+                std::vector<uint8_t> col(bytes);
+                archivo.read(reinterpret_cast<char*>(col.data()), bytes);
+                if (archivo.gcount() != static_cast<std::streamsize>(bytes))
+                    throw TrajectoryError("Truncated trajectory chunk");
+                return col;
+            }
+
+            std::ifstream archivo;
+        };
+
+    } // namespace agent
+} // namespace utec
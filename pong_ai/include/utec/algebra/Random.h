@@ -0,0 +1,160 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include "Tensor.h"
+#include "ThreadPool.h"
+
+namespace utec {
+namespace algebra {
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Es una funcion pura de (contador, clave): el valor del elemento i depende
+// solo de (seed, stream, i), asi que cualquier rango se puede generar en
+// cualquier hilo y en cualquier orden con resultados identicos bit a bit.
+struct Philox4x32 {
+    static constexpr uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    static constexpr uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+    static constexpr int ROUNDS = 10;
+
+    // Genera LANES bloques a la vez en formato SoA; los bucles por carril no
+    // tienen dependencias entre si y el compilador los vectoriza.
+    template <unsigned long LANES>
+    static void batch(uint32_t c0[LANES], uint32_t c1[LANES], uint32_t c2[LANES], uint32_t c3[LANES],
+                      uint32_t k0, uint32_t k1) {
+        for (int r = 0; r < ROUNDS; ++r) {
+            for (unsigned long l = 0; l < LANES; ++l) {
+                uint64_t p0 = uint64_t(M0) * c0[l];
+                uint64_t p1 = uint64_t(M1) * c2[l];
+                uint32_t n0 = uint32_t(p1 >> 32) ^ c1[l] ^ k0;
+                uint32_t n1 = uint32_t(p1);
+                uint32_t n2 = uint32_t(p0 >> 32) ^ c3[l] ^ k1;
+                uint32_t n3 = uint32_t(p0);
+                c0[l] = n0; c1[l] = n1; c2[l] = n2; c3[l] = n3;
+            }
+            k0 += W0;
+            k1 += W1;
+        }
+    }
+};
+
+class CounterRNG {
+public:
+    CounterRNG(uint64_t seed, uint64_t stream = 0) : seed_(seed), stream_(stream) {}
+
+    uint64_t seed() const { return seed_; }
+    uint64_t stream() const { return stream_; }
+
+    // 32 bits aleatorios del elemento `index`
+    uint32_t bits(uint64_t index) const {
+        uint32_t c0[1], c1[1], c2[1], c3[1];
+        bloque<1>(index / 4, c0, c1, c2, c3);
+        uint32_t out[4] = {c0[0], c1[0], c2[0], c3[0]};
+        return out[index % 4];
+    }
+
+    // Uniforme en [0, 1)
+    float uniform(uint64_t index) const {
+        return a_unitario(bits(index));
+    }
+
+    // Normal estandar: Box-Muller sobre los pares (0,1) y (2,3) de cada bloque
+    float normal(uint64_t index) const {
+        uint32_t c0[1], c1[1], c2[1], c3[1];
+        bloque<1>(index / 4, c0, c1, c2, c3);
+        float z[4];
+        box_muller(c0[0], c1[0], z[0], z[1]);
+        box_muller(c2[0], c3[0], z[2], z[3]);
+        return z[index % 4];
+    }
+
+    template <typename T>
+    void fill_uniform(T* out, unsigned long n, T lo, T hi, uint64_t offset = 0) const {
+        rellenar(out, n, offset, [lo, hi](const uint32_t (&u)[4], T (&v)[4]) {
+            for (int i = 0; i < 4; ++i)
+                v[i] = lo + (hi - lo) * static_cast<T>(a_unitario(u[i]));
+        });
+    }
+
+    template <typename T>
+    void fill_normal(T* out, unsigned long n, T mean, T stddev, uint64_t offset = 0) const {
+        rellenar(out, n, offset, [mean, stddev](const uint32_t (&u)[4], T (&v)[4]) {
+            float z[4];
+            box_muller(u[0], u[1], z[0], z[1]);
+            box_muller(u[2], u[3], z[2], z[3]);
+            for (int i = 0; i < 4; ++i)
+                v[i] = mean + stddev * static_cast<T>(z[i]);
+        });
+    }
+
+    template <typename T, unsigned long N>
+    void fill_normal(Tensor<T, N>& t, T mean, T stddev, uint64_t offset = 0) const {
+        fill_normal(t.begin(), t.tamano_total(), mean, stddev, offset);
+    }
+
+    template <typename T, unsigned long N>
+    void fill_uniform(Tensor<T, N>& t, T lo, T hi, uint64_t offset = 0) const {
+        fill_uniform(t.begin(), t.tamano_total(), lo, hi, offset);
+    }
+
+private:
+    static constexpr unsigned long LANES = 8;
+
+    template <unsigned long L>
+    void bloque(uint64_t b, uint32_t* c0, uint32_t* c1, uint32_t* c2, uint32_t* c3) const {
+        for (unsigned long l = 0; l < L; ++l) {
+            uint64_t idx = b + l;
+            c0[l] = uint32_t(idx);
+            c1[l] = uint32_t(idx >> 32);
+            c2[l] = uint32_t(stream_);
+            c3[l] = uint32_t(stream_ >> 32);
+        }
+        Philox4x32::batch<L>(c0, c1, c2, c3, uint32_t(seed_), uint32_t(seed_ >> 32));
+    }
+
+    static float a_unitario(uint32_t u) {
+        return static_cast<float>(u >> 8) * (1.0f / 16777216.0f);
+    }
+
+    static void box_muller(uint32_t a, uint32_t b, float& z0, float& z1) {
+        // u1 en (0, 1] para que log no diverja
+        float u1 = (static_cast<float>(a >> 8) + 1.0f) * (1.0f / 16777216.0f);
+        float u2 = a_unitario(b);
+        float r = std::sqrt(-2.0f * std::log(u1));
+        float th = 6.2831853071795864f * u2;
+        z0 = r * std::cos(th);
+        z1 = r * std::sin(th);
+    }
+
+    // Cada bloque Philox da 4 valores; los elementos [offset, offset + n) se
+    // reparten por bloques entre hilos, y cada hilo genera LANES bloques a la vez.
+    template <typename T, typename Transform>
+    void rellenar(T* out, unsigned long n, uint64_t offset, Transform tr) const {
+        if (n == 0) return;
+        uint64_t primero = offset / 4, ultimo = (offset + n - 1) / 4;
+        unsigned long bloques = static_cast<unsigned long>(ultimo - primero + 1);
+        parallel_rows(bloques, 4 * 16, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long b = lo; b < hi; b += LANES) {
+                unsigned long cuantos = std::min(LANES, hi - b);
+                uint32_t c0[LANES], c1[LANES], c2[LANES], c3[LANES];
+                bloque<LANES>(primero + b, c0, c1, c2, c3);
+                for (unsigned long l = 0; l < cuantos; ++l) {
+                    uint32_t u[4] = {c0[l], c1[l], c2[l], c3[l]};
+                    T v[4];
+                    tr(u, v);
+                    uint64_t base = (primero + b + l) * 4;
+                    for (int i = 0; i < 4; ++i) {
+                        uint64_t idx = base + i;
+                        if (idx >= offset && idx < offset + n)
+                            out[idx - offset] = v[i];
+                    }
+                }
+            }
+        });
+    }
+
+    uint64_t seed_;
+    uint64_t stream_;
+};
+
+} // namespace algebra
+} // namespace utec
@@ -6,6 +6,7 @@
 #include <utility>
 #include <functional>
 #include <algorithm>
+#include "ThreadPool.h"
 
 namespace utec {
 namespace algebra {
@@ -17,6 +18,133 @@ public:
     const char* what() const noexcept override { return mensaje; }
 };
 
+// Por debajo de este numero de elementos las operaciones corren en serie:
+// repartir el trabajo entre hilos cuesta mas que hacerlo.
+constexpr unsigned long PARALLEL_THRESHOLD = 1ul << 15;
+
+template <typename Func>
+void parallel_range(unsigned long total, unsigned long grain, Func f) {
+    if (total < PARALLEL_THRESHOLD)
+        f(0ul, total);
+    else
+        parallel::parallel_for(0, total, grain, f);
+}
+
+// Igual que parallel_range pero para bucles por filas donde cada fila cuesta
+// `row_cost` elementos: el umbral y el grano se miden en elementos.
+template <typename Func>
+void parallel_rows(unsigned long rows, unsigned long row_cost, Func f) {
+    row_cost = std::max(1ul, row_cost);
+    if (rows < 2 || rows * row_cost < PARALLEL_THRESHOLD)
+        f(0ul, rows);
+    else
+        parallel::parallel_for(0, rows, std::max(1ul, PARALLEL_THRESHOLD / row_cost), f);
+}
+
+// Plan de broadcasting (reglas de NumPy para tensores del mismo rango): se
+// calcula una vez la forma resultante y los strides de cada operando (0 en
+// las dimensiones que se repiten), se eliminan las dimensiones de tamano 1 y
+// se fusionan las contiguas. Asi el bucle interno recorre tramos contiguos.
+template <unsigned long N>
+struct BroadcastPlan {
+    unsigned long dims[N];
+    unsigned long rank;
+    unsigned long size[N];
+    unsigned long sa[N], sb[N];
+
+    BroadcastPlan(const unsigned long* da, const unsigned long* db) {
+        unsigned long stride_a[N], stride_b[N];
+        unsigned long ea = 1, eb = 1;
+        for (int d = int(N) - 1; d >= 0; --d) {
+            if (da[d] != db[d] && da[d] != 1 && db[d] != 1)
+                throw TensorError("Shapes are not broadcastable");
+            dims[d] = da[d] == 1 ? db[d] : da[d];
+            stride_a[d] = (da[d] == 1) ? 0 : ea;
+            stride_b[d] = (db[d] == 1) ? 0 : eb;
+            ea *= da[d];
+            eb *= db[d];
+        }
+        rank = 0;
+        for (unsigned long d = 0; d < N; ++d) {
+            if (dims[d] == 1) continue;
+            if (rank > 0 &&
+                sa[rank - 1] == stride_a[d] * dims[d] &&
+                sb[rank - 1] == stride_b[d] * dims[d]) {
+                size[rank - 1] *= dims[d];
+                sa[rank - 1] = stride_a[d];
+                sb[rank - 1] = stride_b[d];
+                continue;
+            }
+            size[rank] = dims[d];
+            sa[rank] = stride_a[d];
+            sb[rank] = stride_b[d];
+            ++rank;
+        }
+        if (rank == 0) {
+            size[0] = 1;
+            sa[0] = sb[0] = 0;
+            rank = 1;
+        }
+    }
+
+    unsigned long total() const {
+        unsigned long t = 1;
+        for (unsigned long d = 0; d < rank; ++d) t *= size[d];
+        return t;
+    }
+};
+
+// r (contigua, forma del plan) = op(a, b). El bucle interno se especializa
+// segun si cada operando avanza (stride 1) o se repite (stride 0).
+template <typename T, unsigned long N, typename Op>
+void broadcast_kernel(const BroadcastPlan<N>& p, const T* a, const T* b, T* r, Op op) {
+    const unsigned long L = p.size[p.rank - 1];
+    const unsigned long ia = p.sa[p.rank - 1], ib = p.sb[p.rank - 1];
+    const unsigned long total = p.total();
+    if (total == 0) return;
+    const unsigned long filas = total / L;
+
+    auto run = [&](unsigned long lo, unsigned long hi) {
+        unsigned long idx[N] = {};
+        unsigned long off_a = 0, off_b = 0, resto = lo;
+        for (int d = int(p.rank) - 2; d >= 0; --d) {
+            idx[d] = resto % p.size[d];
+            resto /= p.size[d];
+            off_a += idx[d] * p.sa[d];
+            off_b += idx[d] * p.sb[d];
+        }
+        for (unsigned long f = lo; f < hi; ++f) {
+            T* ro = r + f * L;
+            const T* ao = a + off_a;
+            const T* bo = b + off_b;
+            if (ia == 1 && ib == 1) {
+                for (unsigned long i = 0; i < L; ++i) ro[i] = op(ao[i], bo[i]);
+            } else if (ia == 1) {
+                const T vb = bo[0];
+                for (unsigned long i = 0; i < L; ++i) ro[i] = op(ao[i], vb);
+            } else if (ib == 1) {
+                const T va = ao[0];
+                for (unsigned long i = 0; i < L; ++i) ro[i] = op(va, bo[i]);
+            } else {
+                const T v = op(ao[0], bo[0]);
+                for (unsigned long i = 0; i < L; ++i) ro[i] = v;
+            }
+            for (int d = int(p.rank) - 2; d >= 0; --d) {
+                off_a += p.sa[d];
+                off_b += p.sb[d];
+                if (++idx[d] < p.size[d]) break;
+                off_a -= p.sa[d] * p.size[d];
+                off_b -= p.sb[d] * p.size[d];
+                idx[d] = 0;
+            }
+        }
+    };
+    if (total < PARALLEL_THRESHOLD || filas < 2)
+        run(0, filas);
+    else
+        parallel::parallel_for(0, filas, std::max(1ul, PARALLEL_THRESHOLD / L), run);
+}
+
 template <typename T, unsigned long N>
 class Tensor {
 public:
@@ -197,73 +325,76 @@ public:
 
     friend Tensor<T, N> operator+(const Tensor<T, N>& a, const T& s) {
         Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] + s;
+        parallel_range(a.tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                r.datos[i] = a.datos[i] + s;
+        });
         return r;
     }
     friend Tensor<T, N> operator+(const T& s, const Tensor<T, N>& a) { return a + s; }
 
     friend Tensor<T, N> operator-(const Tensor<T, N>& a, const T& s) {
         Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] - s;
+        parallel_range(a.tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                r.datos[i] = a.datos[i] - s;
+        });
         return r;
     }
     friend Tensor<T, N> operator-(const T& s, const Tensor<T, N>& a) {
         Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = s - a.datos[i];
+        parallel_range(a.tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                r.datos[i] = s - a.datos[i];
+        });
         return r;
     }
 
     friend Tensor<T, N> operator*(const Tensor<T, N>& a, const T& s) {
         Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] * s;
+        parallel_range(a.tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                r.datos[i] = a.datos[i] * s;
+        });
         return r;
     }
     friend Tensor<T, N> operator*(const T& s, const Tensor<T, N>& a) { return a * s; }
 
     friend Tensor<T, N> operator/(const Tensor<T, N>& a, const T& s) {
         Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] / s;
+        parallel_range(a.tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                r.datos[i] = a.datos[i] / s;
+        });
         return r;
     }
 
     friend Tensor<T, N> operator+(const Tensor<T, N>& a, const Tensor<T, N>& b) {
-        if (a.tamano_total() != b.tamano_total())
-            throw TensorError("Tensor sizes do not match for element-wise operation");
-        Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] + b.datos[i];
-        return r;
+        return a.apply(b, [](T x, T y) { return x + y; });
     }
 
     friend Tensor<T, N> operator-(const Tensor<T, N>& a, const Tensor<T, N>& b) {
-        if (a.tamano_total() != b.tamano_total())
-            throw TensorError("Tensor sizes do not match for element-wise operation");
-        Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] - b.datos[i];
-        return r;
+        return a.apply(b, [](T x, T y) { return x - y; });
     }
 
     friend Tensor<T, N> operator*(const Tensor<T, N>& a, const Tensor<T, N>& b) {
-        if (a.tamano_total() != b.tamano_total())
-            throw TensorError("Tensor sizes do not match for element-wise operation");
-        Tensor<T, N> r = a;
-        unsigned long total = a.tamano_total();
-        for (unsigned long i = 0; i < total; ++i)
-            r.datos[i] = a.datos[i] * b.datos[i];
-        return r;
+        return a.apply(b, [](T x, T y) { return x * y; });
+    }
+
+    friend Tensor<T, N> operator/(const Tensor<T, N>& a, const Tensor<T, N>& b) {
+        return a.apply(b, [](T x, T y) { return x / y; });
+    }
+
+    Tensor<T, N>& operator+=(const Tensor<T, N>& o) {
+        return apply_inplace(o, [](T x, T y) { return x + y; });
+    }
+
+    Tensor<T, N>& operator-=(const Tensor<T, N>& o) {
+        return apply_inplace(o, [](T x, T y) { return x - y; });
+    }
+
+    Tensor<T, N>& operator*=(const Tensor<T, N>& o) {
+        return apply_inplace(o, [](T x, T y) { return x * y; });
     }
 
     friend std::ostream& operator<<(std::ostream& os, const Tensor<T, N>& t) {
@@ -308,13 +439,47 @@ public:
     template<typename Func>
     Tensor<T, N> apply(Func f) const {
         Tensor<T, N> result = *this;
-        unsigned long total = tamano_total();
-        for (unsigned long i = 0; i < total; ++i) {
-            result.datos[i] = f(datos[i]);
+        parallel_range(tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+            for (unsigned long i = lo; i < hi; ++i)
+                result.datos[i] = f(datos[i]);
+        });
+        return result;
+    }
+
+    // Operacion elemento a elemento con broadcasting (reglas de NumPy)
+    template<typename Func>
+    Tensor<T, N> apply(const Tensor<T, N>& other, Func f) const {
+        if (misma_forma(other)) {
+            Tensor<T, N> result = con_forma(dimensiones);
+            parallel_range(tamano_total(), PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+                for (unsigned long i = lo; i < hi; ++i)
+                    result.datos[i] = f(datos[i], other.datos[i]);
+            });
+            return result;
         }
+        BroadcastPlan<N> plan(dimensiones, other.dimensiones);
+        Tensor<T, N> result = con_forma(plan.dims);
+        broadcast_kernel(plan, datos, other.datos, result.datos, f);
         return result;
     }
 
+    // Reducciones sobre un eje; el eje reducido queda con tamano 1 para que
+    // el resultado siga siendo broadcastable contra el original.
+    Tensor<T, N> sum(unsigned long axis) const {
+        return reducir(axis, [](T acc, T v) { return acc + v; });
+    }
+
+    Tensor<T, N> mean(unsigned long axis) const {
+        Tensor<T, N> r = sum(axis);
+        return r / static_cast<T>(dimensiones[axis]);
+    }
+
+    Tensor<T, N> max(unsigned long axis) const {
+        if (axis < N && dimensiones[axis] == 0)
+            throw TensorError("max over an empty axis");
+        return reducir(axis, [](T acc, T v) { return v > acc ? v : acc; });
+    }
+
     Tensor<T, N> transpose_2d() const {
         if constexpr (N != 2) {
             throw TensorError("transpose_2d only works for 2D tensors");
@@ -329,6 +494,75 @@ public:
     }
 
 private:
+    static Tensor<T, N> con_forma(const unsigned long dims[N]) {
+        Tensor<T, N> t;
+        unsigned long total = 1;
+        for (unsigned long i = 0; i < N; ++i) {
+            t.dimensiones[i] = dims[i];
+            total *= dims[i];
+        }
+        t.datos = new T[total]();
+        t.capacidad = total;
+        return t;
+    }
+
+    bool misma_forma(const Tensor<T, N>& o) const {
+        for (unsigned long i = 0; i < N; ++i)
+            if (dimensiones[i] != o.dimensiones[i]) return false;
+        return true;
+    }
+
+    template<typename Func>
+    Tensor<T, N>& apply_inplace(const Tensor<T, N>& o, Func f) {
+        BroadcastPlan<N> plan(dimensiones, o.dimensiones);
+        for (unsigned long i = 0; i < N; ++i)
+            if (plan.dims[i] != dimensiones[i])
+                throw TensorError("Cannot broadcast result into tensor shape");
+        broadcast_kernel(plan, datos, o.datos, datos, f);
+        return *this;
+    }
+
+    // Vista (outer, len, inner) alrededor del eje: el bucle interno recorre
+    // `inner` elementos contiguos para cada paso del eje reducido.
+    template<typename Op>
+    Tensor<T, N> reducir(unsigned long axis, Op op) const {
+        if (axis >= N)
+            throw TensorError("Reduction axis out of range");
+        unsigned long outer = 1, inner = 1, len = dimensiones[axis];
+        for (unsigned long d = 0; d < axis; ++d) outer *= dimensiones[d];
+        for (unsigned long d = axis + 1; d < N; ++d) inner *= dimensiones[d];
+        unsigned long dims[N];
+        for (unsigned long d = 0; d < N; ++d) dims[d] = dimensiones[d];
+        dims[axis] = 1;
+        Tensor<T, N> r = con_forma(dims);
+        if (len == 0) return r;
+
+        const T* a = datos;
+        T* out = r.datos;
+        auto run = [&](unsigned long o_lo, unsigned long o_hi, unsigned long j_lo, unsigned long j_hi) {
+            for (unsigned long o = o_lo; o < o_hi; ++o) {
+                T* ro = out + o * inner;
+                const T* base = a + o * len * inner;
+                for (unsigned long j = j_lo; j < j_hi; ++j) ro[j] = base[j];
+                for (unsigned long k = 1; k < len; ++k) {
+                    const T* ak = base + k * inner;
+                    for (unsigned long j = j_lo; j < j_hi; ++j) ro[j] = op(ro[j], ak[j]);
+                }
+            }
+        };
+        unsigned long total = tamano_total();
+        if (total < PARALLEL_THRESHOLD) {
+            run(0, outer, 0, inner);
+        } else if (outer >= 2) {
+            parallel::parallel_for(0, outer, std::max(1ul, PARALLEL_THRESHOLD / (len * inner)),
+                [&](unsigned long lo, unsigned long hi) { run(lo, hi, 0, inner); });
+        } else {
+            parallel::parallel_for(0, inner, std::max(1ul, PARALLEL_THRESHOLD / len),
+                [&](unsigned long lo, unsigned long hi) { run(0, 1, lo, hi); });
+        }
+        return r;
+    }
+
     T* datos;
     unsigned long dimensiones[N];
     unsigned long capacidad;
@@ -344,14 +578,28 @@ Tensor<T, 2> matrix_product(const Tensor<T, 2>& A, const Tensor<T, 2>& B) {
         throw TensorError("Matrix dimensions are incompatible for multiplication");
     }
     Tensor<T, 2> R(M, N);
-    for (unsigned long i = 0; i < M; ++i) {
-        for (unsigned long j = 0; j < N; ++j) {
-            T sum = T();
+    const T* a = A.begin();
+    const T* b = B.begin();
+    T* r = R.begin();
+    // Orden i-k-j: el bucle interno recorre filas contiguas de B y R.
+    // Las filas de R se reparten entre hilos cuando hay trabajo suficiente.
+    auto filas = [&](unsigned long lo, unsigned long hi) {
+        for (unsigned long i = lo; i < hi; ++i) {
+            T* ri = r + i * N;
             for (unsigned long k = 0; k < K; ++k) {
-                sum += A(i, k) * B(k, j);
+                T aik = a[i * K + k];
+                const T* bk = b + k * N;
+                for (unsigned long j = 0; j < N; ++j)
+                    ri[j] += aik * bk[j];
             }
-            R(i, j) = sum;
         }
+    };
+    unsigned long trabajo = M * N * K;
+    if (trabajo < PARALLEL_THRESHOLD || M < 2) {
+        filas(0, M);
+    } else {
+        unsigned long grano = std::max(1ul, PARALLEL_THRESHOLD / std::max(1ul, N * K));
+        parallel::parallel_for(0, M, grano, filas);
     }
     return R;
 }
@@ -14,15 +14,19 @@ namespace utec {
             }
 
             Tensor2<T> backward(const Tensor2<T>& grad) override {
-                auto result = grad;
-                for (size_t i = 0; i < result.shape()[0]; ++i) {
-                    for (size_t j = 0; j < result.shape()[1]; ++j) {
-                        if (mask(i, j) <= T(0)) {
-                            result(i, j) = T(0);
-                        }
-                    }
-                }
-                return result;
+                return grad.apply(mask, [](T g, T m) { return m > T(0) ? g : T(0); });
+            }
+
+            std::unique_ptr<ILayer<T>> clone() const override {
+                return std::make_unique<ReLU<T>>();
+            }
+
+            void release_cache() override {
+                mask = Tensor2<T>();
+            }
+
+            size_t cache_bytes() const override {
+                return mask.tamano_total() * sizeof(T);
             }
 
         private:
@@ -0,0 +1,402 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <cmath>
+#include "Tensor.h"
+#include "layer.h"
+
+namespace utec {
+    namespace nn {
+
+        // Cinta de autodiferenciacion en modo reverso sobre Tensor2.
+        //
+        // Cada operacion registra un nodo con su valor y solo lo que su backward
+        // necesita (p. ej. add no guarda valores, relu solo su salida). En
+        // backward los valores y gradientes intermedios se liberan en cuanto
+        // su ultimo consumidor los usa, y las cadenas de operaciones unarias
+        // elemento a elemento se fusionan en un solo recorrido.
+        template<typename T>
+        class Tape {
+        public:
+            struct Var { size_t id; };
+
+            Tape() = default;
+            // Los backward de cada nodo capturan `this`: una copia apuntaria a la original
+            Tape(const Tape&) = delete;
+            Tape& operator=(const Tape&) = delete;
+
+            // Hoja sin gradiente (datos) o con gradiente (entrada de una capa)
+            Var input(const Tensor2<T>& x, bool requires_grad = false) {
+                Node n;
+                n.value = x;
+                n.requires_grad = requires_grad;
+                n.leaf = true;
+                return push(std::move(n));
+            }
+
+            // Parametro externo: no se copia, la cinta lo referencia
+            Var param(const Tensor2<T>& p) {
+                Node n;
+                n.externo = &p;
+                n.requires_grad = true;
+                n.leaf = true;
+                return push(std::move(n));
+            }
+
+            Var matmul(Var a, Var b) {
+                Node n = binary(a, b, algebra::matrix_product(value(a), value(b)));
+                lee(n, a, 0);
+                lee(n, b, 1);
+                n.backward = [this](Node& self, const Tensor2<T>& g) {
+                    size_t ia = self.inputs[0], ib = self.inputs[1];
+                    if (nodes[ia].requires_grad)
+                        acumular(ia, algebra::matrix_product(g, valor(ib).transpose_2d()));
+                    if (nodes[ib].requires_grad)
+                        acumular(ib, algebra::matrix_product(valor(ia).transpose_2d(), g));
+                };
+                return push(std::move(n));
+            }
+
+            Var add(Var a, Var b) {
+                Node n = binary(a, b, value(a) + value(b));
+                n.backward = [this](Node& self, const Tensor2<T>& g) {
+                    for (size_t k = 0; k < 2; ++k)
+                        if (nodes[self.inputs[k]].requires_grad)
+                            acumular(self.inputs[k], reducir_a(g, self.input_shape[k]));
+                };
+                return push(std::move(n));
+            }
+
+            Var sub(Var a, Var b) {
+                Node n = binary(a, b, value(a) - value(b));
+                n.backward = [this](Node& self, const Tensor2<T>& g) {
+                    if (nodes[self.inputs[0]].requires_grad)
+                        acumular(self.inputs[0], reducir_a(g, self.input_shape[0]));
+                    if (nodes[self.inputs[1]].requires_grad)
+                        acumular(self.inputs[1], reducir_a(g * T(-1), self.input_shape[1]));
+                };
+                return push(std::move(n));
+            }
+
+            Var mul(Var a, Var b) {
+                Node n = binary(a, b, value(a) * value(b));
+                lee(n, a, 0);
+                lee(n, b, 1);
+                n.backward = [this](Node& self, const Tensor2<T>& g) {
+                    size_t ia = self.inputs[0], ib = self.inputs[1];
+                    if (nodes[ia].requires_grad)
+                        acumular(ia, reducir_a(g * valor(ib), self.input_shape[0]));
+                    if (nodes[ib].requires_grad)
+                        acumular(ib, reducir_a(g * valor(ia), self.input_shape[1]));
+                };
+                return push(std::move(n));
+            }
+
+            Var relu(Var a) {
+                return unary(a, [](T x) { return x > T(0) ? x : T(0); },
+                             [](T, T y, T) { return y > T(0) ? T(1) : T(0); }, false, true);
+            }
+
+            Var sigmoid(Var a) {
+                return unary(a, [](T x) { return T(1) / (T(1) + std::exp(-x)); },
+                             [](T, T y, T) { return y * (T(1) - y); }, false, true);
+            }
+
+            Var tanh(Var a) {
+                return unary(a, [](T x) { return std::tanh(x); },
+                             [](T, T y, T) { return T(1) - y * y; }, false, true);
+            }
+
+            Var square(Var a) {
+                return unary(a, [](T x) { return x * x; },
+                             [](T x, T, T) { return T(2) * x; }, true, false);
+            }
+
+            Var scale(Var a, T s) {
+                return unary(a, [s](T x) { return x * s; },
+                             [](T, T, T p) { return p; }, false, false, s);
+            }
+
+            // Suma sobre un eje (el eje queda de tamano 1)
+            Var sum(Var a, size_t axis) {
+                Node n;
+                n.value = value(a).sum(axis);
+                n.inputs = {a.id};
+                n.input_shape.push_back(forma(a));
+                n.requires_grad = nodes[a.id].requires_grad;
+                // Cuenta como consumidor aunque no lea el valor: fusionar_unarios
+                // no debe liberar un nodo que tambien alimenta a esta suma
+                nodes[a.id].consumidores++;
+                n.backward = [this](Node& self, const Tensor2<T>& g) {
+                    const auto& s = self.input_shape[0];
+                    Tensor2<T> full(s[0], s[1]);
+                    full += g;
+                    acumular(self.inputs[0], std::move(full));
+                };
+                return push(std::move(n));
+            }
+
+            // Media de los cuadrados de la diferencia sobre el lote, como MSELoss
+            Var mse(Var pred, Var target) {
+                auto d = sub(pred, target);
+                auto s = sum(sum(square(d), 1), 0);
+                return scale(s, T(1) / T(value(pred).shape()[0]));
+            }
+
+            const Tensor2<T>& value(Var v) const { return valor(v.id); }
+
+            // Gradiente acumulado de una hoja tras backward()
+            const Tensor2<T>& grad(Var v) const { return nodes[v.id].grad; }
+
+            // Propaga desde `out` con gradiente inicial `seed` (unos si se omite)
+            void backward(Var out, const Tensor2<T>& seed) {
+                raiz = out.id;
+                // Valores que ningun backward va a leer se liberan de inmediato
+                for (size_t i = 0; i < raiz; ++i)
+                    liberar_si_no_usado(i);
+                acumular(out.id, seed);
+
+                for (size_t i = out.id + 1; i-- > 0; ) {
+                    Node& n = nodes[i];
+                    if (n.leaf || !n.requires_grad || n.grad.tamano_total() == 0)
+                        continue;
+                    if (n.deriv) {
+                        fusionar_unarios(i);
+                    } else {
+                        n.backward(n, n.grad);
+                        consumir(n);
+                    }
+                    n.grad = Tensor2<T>();
+                }
+            }
+
+            void backward(Var out) {
+                const auto& v = value(out);
+                Tensor2<T> seed(v.shape()[0], v.shape()[1]);
+                seed.fill(T(1));
+                backward(out, seed);
+            }
+
+            void clear() {
+                nodes.clear();
+            }
+
+            size_t size() const { return nodes.size(); }
+
+            // Bytes de valores y gradientes que la cinta mantiene vivos
+            size_t bytes() const {
+                size_t total = 0;
+                for (auto& n : nodes)
+                    total += (n.value.tamano_total() + n.grad.tamano_total()) * sizeof(T);
+                return total;
+            }
+
+        private:
+            using Deriv = T (*)(T x, T y, T param);
+
+            struct Node {
+                Tensor2<T> value;
+                Tensor2<T> grad;
+                const Tensor2<T>* externo = nullptr;
+                std::vector<size_t> inputs;
+                std::vector<std::vector<unsigned long>> input_shape;
+                std::function<void(Node&, const Tensor2<T>&)> backward;
+                // Unario elemento a elemento: dy/dx = deriv(x, y, param)
+                Deriv deriv = nullptr;
+                T param = T(0);
+                bool lee_entrada[2] = {false, false};
+                bool lee_salida = false;
+                size_t usos = 0;        // backwards pendientes que leen `value`
+                size_t consumidores = 0;
+                bool requires_grad = false;
+                bool leaf = false;
+            };
+
+            Var push(Node n) {
+                nodes.push_back(std::move(n));
+                return Var{nodes.size() - 1};
+            }
+
+            const Tensor2<T>& valor(size_t id) const {
+                return nodes[id].externo ? *nodes[id].externo : nodes[id].value;
+            }
+
+            std::vector<unsigned long> forma(Var v) const {
+                const auto& t = value(v);
+                return {t.shape()[0], t.shape()[1]};
+            }
+
+            // El backward de n leera el valor de su entrada k
+            void lee(Node& n, Var v, size_t k) {
+                n.lee_entrada[k] = true;
+                nodes[v.id].usos++;
+            }
+
+            Node binary(Var a, Var b, Tensor2<T> out) {
+                Node n;
+                n.value = std::move(out);
+                n.inputs = {a.id, b.id};
+                n.input_shape = {forma(a), forma(b)};
+                n.requires_grad = nodes[a.id].requires_grad || nodes[b.id].requires_grad;
+                nodes[a.id].consumidores++;
+                nodes[b.id].consumidores++;
+                return n;
+            }
+
+            template<typename F>
+            Var unary(Var a, F f, Deriv d, bool usa_entrada, bool usa_salida, T param = T(0)) {
+                Node n;
+                n.value = value(a).apply(f);
+                n.inputs = {a.id};
+                n.requires_grad = nodes[a.id].requires_grad;
+                n.deriv = d;
+                n.param = param;
+                n.lee_salida = usa_salida;
+                if (usa_salida) n.usos++;
+                nodes[a.id].consumidores++;
+                if (usa_entrada) lee(n, a, 0);
+                return push(std::move(n));
+            }
+
+            // Recorre hacia abajo la cadena de unarios con un solo consumidor y
+            // aplica todas sus derivadas en un unico bucle, sin materializar los
+            // gradientes intermedios.
+            void fusionar_unarios(size_t i) {
+                std::vector<size_t> cadena{i};
+                size_t destino = nodes[i].inputs[0];
+                while (nodes[destino].deriv && !nodes[destino].leaf &&
+                       nodes[destino].consumidores == 1 && destino != raiz &&
+                       nodes[destino].grad.tamano_total() == 0) {
+                    cadena.push_back(destino);
+                    destino = nodes[destino].inputs[0];
+                }
+                if (!nodes[destino].requires_grad) {
+                    for (size_t k : cadena) consumir(nodes[k]);
+                    return;
+                }
+
+                Tensor2<T> g = std::move(nodes[i].grad);
+                T* gp = g.begin();
+                unsigned long total = g.tamano_total();
+                for (size_t k : cadena) {
+                    Node& u = nodes[k];
+                    const T* y = u.lee_salida ? u.value.begin() : nullptr;
+                    const T* x = u.lee_entrada[0] ? valor(u.inputs[0]).begin() : nullptr;
+                    Deriv d = u.deriv;
+                    T p = u.param;
+                    algebra::parallel_range(total, algebra::PARALLEL_THRESHOLD, [&](unsigned long lo, unsigned long hi) {
+                        for (unsigned long e = lo; e < hi; ++e)
+                            gp[e] *= d(x ? x[e] : T(0), y ? y[e] : T(0), p);
+                    });
+                }
+                for (size_t k : cadena) {
+                    consumir(nodes[k]);
+                    nodes[k].grad = Tensor2<T>();
+                }
+                acumular(destino, std::move(g));
+            }
+
+            // El backward de n ya leyo los valores que necesitaba
+            void consumir(Node& n) {
+                size_t id = &n - nodes.data();
+                if (n.lee_salida) {
+                    n.usos--;
+                    liberar_si_no_usado(id);
+                }
+                for (size_t k = 0; k < n.inputs.size(); ++k) {
+                    if (n.lee_entrada[k]) {
+                        nodes[n.inputs[k]].usos--;
+                        liberar_si_no_usado(n.inputs[k]);
+                    }
+                }
+            }
+
+            void liberar_si_no_usado(size_t id) {
+                Node& n = nodes[id];
+                if (n.usos == 0 && !n.leaf && id != raiz)
+                    n.value = Tensor2<T>();
+            }
+
+            void acumular(size_t id, Tensor2<T> g) {
+                Node& n = nodes[id];
+                if (n.grad.tamano_total() == 0)
+                    n.grad = std::move(g);
+                else
+                    n.grad += g;
+            }
+
+            // Suma sobre los ejes en que el operando fue broadcasteado
+            static Tensor2<T> reducir_a(const Tensor2<T>& g, const std::vector<unsigned long>& s) {
+                if (g.shape()[0] == s[0] && g.shape()[1] == s[1])
+                    return g;
+                Tensor2<T> r = g;
+                if (s[0] == 1 && r.shape()[0] != 1) r = r.sum(0);
+                if (s[1] == 1 && r.shape()[1] != 1) r = r.sum(1);
+                return r;
+            }
+
+            std::vector<Node> nodes;
+            size_t raiz = 0;
+        };
+
+        // Capa cuyo backward sale de la cinta: basta con escribir el forward
+        // con operaciones de Tape. Los parametros se actualizan con SGD.
+        template<typename T>
+        class AutogradLayer : public ILayer<T> {
+        public:
+            using Var = typename Tape<T>::Var;
+            using Fn = std::function<Var(Tape<T>&, Var, const std::vector<Var>&)>;
+
+            AutogradLayer(std::vector<Tensor2<T>> params, Fn fn)
+              : params_(std::move(params)), grads_(params_.size()), fn_(std::move(fn)) {}
+
+            Tensor2<T> forward(const Tensor2<T>& input) override {
+                tape_.clear();
+                x_ = tape_.input(input, true);
+                vars_.clear();
+                for (auto& p : params_)
+                    vars_.push_back(tape_.param(p));
+                out_ = fn_(tape_, x_, vars_);
+                return tape_.value(out_);
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                tape_.backward(out_, grad_output);
+                for (size_t k = 0; k < params_.size(); ++k)
+                    grads_[k] = tape_.grad(vars_[k]);
+                Tensor2<T> dx = tape_.grad(x_);
+                tape_.clear();
+                return dx;
+            }
+
+            void optimize(T lr) override {
+                for (size_t k = 0; k < params_.size(); ++k)
+                    if (grads_[k].tamano_total() != 0)
+                        params_[k] -= grads_[k] * lr;
+            }
+
+            std::unique_ptr<ILayer<T>> clone() const override {
+                return std::make_unique<AutogradLayer<T>>(params_, fn_);
+            }
+
+            void release_cache() override {
+                tape_.clear();
+            }
+
+            size_t cache_bytes() const override {
+                return tape_.bytes();
+            }
+
+            const std::vector<Tensor2<T>>& params() const { return params_; }
+            const std::vector<Tensor2<T>>& grads() const { return grads_; }
+
+        private:
+            std::vector<Tensor2<T>> params_, grads_;
+            Fn fn_;
+            Tape<T> tape_;
+            Var x_{0}, out_{0};
+            std::vector<Var> vars_;
+        };
+
+    } // namespace nn
+} // namespace utec
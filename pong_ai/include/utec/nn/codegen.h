@@ -0,0 +1,277 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <fstream>
+#include <type_traits>
+#include <exception>
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+#include "Tensor.h"
+#include "layer.h"
+#include "dense.h"
+#include "sparse_dense.h"
+#include "activation.h"
+#include "dropout.h"
+#include "conv.h"
+#include "neural_network.h"
+
+namespace utec {
+    namespace nn {
+
+        class CodegenError : public std::exception {
+            std::string mensaje;
+        public:
+            CodegenError(std::string m) : mensaje(std::move(m)) {}
+            const char* what() const noexcept override { return mensaje.c_str(); }
+        };
+
+        struct GeneratedNetwork {
+            std::string source;
+            size_t in_features = 0;
+            size_t out_features = 0;
+        };
+
+        // Traduce una red congelada a C++ con los pesos como literales
+        // hexadecimales (exactos bit a bit) y todas las dimensiones como
+        // constantes: una sola funcion en linea recta, sin despacho virtual ni
+        // tensores intermedios, que el compilador vectoriza y desenrolla.
+        // Las capas con a lo sumo `unroll_limit` pesos no nulos se emiten
+        // desenrolladas a mano, omitiendo los ceros de SparseDense; en
+        // bench_jit los bucles de tamano fijo ganan a partir de unas decenas
+        // de pesos, por eso el valor por defecto es 0. Exporta
+        //   extern "C" void utec_forward(const T* x, T* y, size_t batch)
+        // Soporta Dense, SparseDense, ReLU y, como identidad, Dropout y Flatten.
+        template<typename T>
+        GeneratedNetwork generate_cpp(const NeuralNetwork<T>& net, size_t unroll_limit = 0) {
+            static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                          "generate_cpp only supports float and double");
+            const char* tipo = std::is_same<T, float>::value ? "float" : "double";
+            const char* sufijo = std::is_same<T, float>::value ? "f" : "";
+
+            auto literal = [sufijo](T v) {
+                std::ostringstream s;
+                s << std::hexfloat << static_cast<double>(v) << sufijo;
+                return s.str();
+            };
+
+            std::ostringstream cuerpo, globales;
+            size_t ancho = 0, entrada = 0, capa = 0;
+            std::string actual = "x";
+
+            auto lineal = [&](const Tensor2<T>& W, const Tensor2<T>& b) {
+                size_t in = W.shape()[0], out = W.shape()[1];
+                if (ancho == 0) entrada = ancho = in;
+                if (in != ancho)
+                    throw CodegenError("generate_cpp: layer " + std::to_string(capa) + " expects " +
+                                       std::to_string(in) + " inputs, got " + std::to_string(ancho));
+                std::string sig = "h" + std::to_string(capa);
+                cuerpo << "        " << tipo << " " << sig << "[" << out << "];\n";
+                size_t no_nulos = 0;
+                for (auto v : W) no_nulos += v != T(0);
+                if (no_nulos <= unroll_limit) {
+                    // Mismo orden que matrix_product (i-k-j): por cada entrada k se
+                    // acumula x[k] * W(k, j) en todas las salidas, y al final + b.
+                    // Las sentencias consecutivas en j las agrupa el vectorizador SLP.
+                    std::vector<bool> iniciada(out, false);
+                    for (size_t k = 0; k < in; ++k) {
+                        for (size_t j = 0; j < out; ++j) {
+                            if (W(k, j) == T(0)) continue;
+                            cuerpo << "        " << sig << "[" << j << "] " << (iniciada[j] ? "+=" : "=")
+                                   << " " << actual << "[" << k << "] * " << literal(W(k, j)) << ";\n";
+                            iniciada[j] = true;
+                        }
+                    }
+                    for (size_t j = 0; j < out; ++j)
+                        cuerpo << "        " << sig << "[" << j << "] " << (iniciada[j] ? "+=" : "=")
+                               << " " << literal(b(0, j)) << ";\n";
+                } else {
+                    // W por filas (in, out): bucle i-k-j con el interno contiguo en j
+                    std::string w = "W" + std::to_string(capa), bb = "B" + std::to_string(capa);
+                    globales << "static const " << tipo << " " << w << "[" << in * out << "] = {";
+                    for (size_t k = 0; k < in; ++k)
+                        for (size_t j = 0; j < out; ++j)
+                            globales << (j + k ? "," : "") << (j == 0 ? "\n    " : "") << literal(W(k, j));
+                    globales << "};\nstatic const " << tipo << " " << bb << "[" << out << "] = {";
+                    for (size_t j = 0; j < out; ++j)
+                        globales << (j ? "," : "") << literal(b(0, j));
+                    globales << "};\n";
+                    cuerpo << "        for (size_t j = 0; j < " << out << "; ++j)\n"
+                           << "            " << sig << "[j] = " << literal(T(0)) << ";\n"
+                           << "        for (size_t k = 0; k < " << in << "; ++k) {\n"
+                           << "            const " << tipo << " xk = " << actual << "[k];\n"
+                           << "            for (size_t j = 0; j < " << out << "; ++j)\n"
+                           << "                " << sig << "[j] += xk * " << w << "[k * " << out << " + j];\n"
+                           << "        }\n"
+                           << "        for (size_t j = 0; j < " << out << "; ++j)\n"
+                           << "            " << sig << "[j] += " << bb << "[j];\n";
+                }
+                actual = sig;
+                ancho = out;
+            };
+
+            for (size_t i = 0; i < net.num_layers(); ++i, ++capa) {
+                const ILayer<T>& l = net.layer(i);
+                if (auto* d = dynamic_cast<const Dense<T>*>(&l)) {
+                    lineal(d->weights(), d->bias());
+                } else if (auto* s = dynamic_cast<const SparseDense<T>*>(&l)) {
+                    lineal(s->to_dense(), s->bias());
+                } else if (dynamic_cast<const ReLU<T>*>(&l)) {
+                    if (ancho == 0)
+                        throw CodegenError("generate_cpp: network must start with a Dense layer");
+                    if (ancho <= unroll_limit) {
+                        for (size_t j = 0; j < ancho; ++j)
+                            cuerpo << "        " << actual << "[" << j << "] = " << actual << "[" << j
+                                   << "] > " << literal(T(0)) << " ? " << actual << "[" << j << "] : "
+                                   << literal(T(0)) << ";\n";
+                    } else {
+                        cuerpo << "        for (size_t j = 0; j < " << ancho << "; ++j)\n"
+                               << "            " << actual << "[j] = " << actual << "[j] > " << literal(T(0))
+                               << " ? " << actual << "[j] : " << literal(T(0)) << ";\n";
+                    }
+                } else if (dynamic_cast<const Dropout<T>*>(&l) || dynamic_cast<const Flatten<T>*>(&l)) {
+                    // Inferencia: dropout invertido y Flatten sobre (N, C*H*W) son la identidad
+                } else {
+                    throw CodegenError("generate_cpp: unsupported layer at index " + std::to_string(i));
+                }
+            }
+            if (ancho == 0)
+                throw CodegenError("generate_cpp: network has no Dense layers");
+
+            GeneratedNetwork g;
+            g.in_features = entrada;
+            g.out_features = ancho;
+            std::ostringstream src;
+            src << "// Generado por utec::nn::generate_cpp. No editar.\n"
+                << "#include <cstddef>\n\n"
+                << globales.str() << "\n"
+                << "extern \"C\" void utec_forward(const " << tipo << "* __restrict in, "
+                << tipo << "* __restrict out, size_t batch) {\n"
+                << "    for (size_t i = 0; i < batch; ++i) {\n"
+                << "        const " << tipo << "* x = in + i * " << entrada << ";\n"
+                << cuerpo.str()
+                << "        for (size_t j = 0; j < " << ancho << "; ++j)\n"
+                << "            out[i * " << ancho << " + j] = " << actual << "[j];\n"
+                << "    }\n"
+                << "}\n";
+            g.source = src.str();
+            return g;
+        }
+
+#if defined(__unix__) || defined(__APPLE__)
+        // generate_cpp es portable; compilar y cargar el .so requiere POSIX
+        struct JitOptions {
+            // Vacio: $CXX o, si no esta definida, "c++"
+            std::string compiler;
+            std::string flags = "-O2 -march=native";
+            size_t unroll_limit = 0;
+        };
+
+        // Red congelada compilada a un .so y cargada con dlopen. Los pesos
+        // se copian al generar: cambios posteriores en `net` no la afectan.
+        template<typename T>
+        class CompiledNetwork {
+        public:
+            explicit CompiledNetwork(const NeuralNetwork<T>& net, JitOptions opts = JitOptions()) {
+                auto g = generate_cpp(net, opts.unroll_limit);
+                in_features_ = g.in_features;
+                out_features_ = g.out_features;
+
+                char plantilla[] = "/tmp/utec_jit_XXXXXX";
+                if (!mkdtemp(plantilla))
+                    throw CodegenError("CompiledNetwork: cannot create temporary directory");
+                dir = plantilla;
+                std::string cpp = dir + "/net.cpp", so = dir + "/net.so", log = dir + "/cc.log";
+                {
+                    std::ofstream f(cpp);
+                    f << g.source;
+                    if (!f) {
+                        limpiar();
+                        throw CodegenError("CompiledNetwork: cannot write " + cpp);
+                    }
+                }
+
+                std::string cc = opts.compiler;
+                if (cc.empty()) {
+                    const char* env = std::getenv("CXX");
+                    cc = env && *env ? env : "c++";
+                }
+                std::string cmd = cc + " -std=c++17 " + opts.flags + " -shared -fPIC -o " + so + " " + cpp +
+                                  " > " + log + " 2>&1";
+                if (std::system(cmd.c_str()) != 0) {
+                    std::ifstream f(log);
+                    std::string salida((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                    limpiar();
+                    throw CodegenError("CompiledNetwork: compilation failed: " + cmd + "\n" + salida);
+                }
+
+                handle = dlopen(so.c_str(), RTLD_NOW | RTLD_LOCAL);
+                if (!handle) {
+                    std::string err = dlerror();
+                    limpiar();
+                    throw CodegenError("CompiledNetwork: dlopen failed: " + err);
+                }
+                fn = reinterpret_cast<Fn>(dlsym(handle, "utec_forward"));
+                if (!fn) {
+                    limpiar();
+                    throw CodegenError("CompiledNetwork: symbol utec_forward not found");
+                }
+                borrar_archivos();
+            }
+
+            CompiledNetwork(const CompiledNetwork&) = delete;
+            CompiledNetwork& operator=(const CompiledNetwork&) = delete;
+
+            ~CompiledNetwork() { limpiar(); }
+
+            // in: batch filas de in_features(); out: batch filas de out_features()
+            void run(const T* in, T* out, size_t batch = 1) const {
+                fn(in, out, batch);
+            }
+
+            Tensor2<T> forward(const Tensor2<T>& X) const {
+                if (X.shape()[1] != in_features_)
+                    throw algebra::TensorError("CompiledNetwork: input features do not match");
+                Tensor2<T> Y(X.shape()[0], out_features_);
+                fn(X.begin(), Y.begin(), X.shape()[0]);
+                return Y;
+            }
+
+            size_t in_features() const { return in_features_; }
+            size_t out_features() const { return out_features_; }
+
+        private:
+            using Fn = void (*)(const T*, T*, size_t);
+
+            void limpiar() {
+                if (handle) {
+                    dlclose(handle);
+                    handle = nullptr;
+                }
+                borrar_archivos();
+            }
+
+            // Tras dlopen el .so ya esta mapeado y los archivos sobran
+            void borrar_archivos() {
+                if (dir.empty()) return;
+                for (const char* f : {"/net.cpp", "/net.so", "/cc.log"})
+                    std::remove((dir + f).c_str());
+                rmdir(dir.c_str());
+                dir.clear();
+            }
+
+            void* handle = nullptr;
+            Fn fn = nullptr;
+            std::string dir;
+            size_t in_features_ = 0, out_features_ = 0;
+        };
+
+#endif
+
+    } // namespace nn
+} // namespace utec
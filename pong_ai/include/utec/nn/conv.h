@@ -0,0 +1,476 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Tensor.h"
+#include "Random.h"
+#include "ThreadPool.h"
+#include "layer.h"
+
+namespace utec {
+    namespace nn {
+
+        template<typename T>
+        using Tensor4 = algebra::Tensor<T, 4>;
+
+        // Las capas convolucionales trabajan sobre Tensor<T,4> en NCHW. Para
+        // encadenarse con Dense dentro de NeuralNetwork tambien implementan
+        // ILayer: cada fila del Tensor2 es una imagen (C*H*W), que en memoria
+        // es exactamente el mismo layout que NCHW.
+        template<typename T>
+        Tensor4<T> to_nchw(const Tensor2<T>& x, size_t C, size_t H, size_t W) {
+            if (x.shape()[1] != C * H * W)
+                throw algebra::TensorError("Row size does not match C*H*W");
+            Tensor4<T> r(x.shape()[0], C, H, W);
+            std::copy(x.begin(), x.end(), r.begin());
+            return r;
+        }
+
+        template<typename T>
+        Tensor2<T> flatten(const Tensor4<T>& x) {
+            const unsigned long* d = x.shape();
+            Tensor2<T> r(d[0], d[1] * d[2] * d[3]);
+            std::copy(x.begin(), x.end(), r.begin());
+            return r;
+        }
+
+        enum class ConvAlgo {
+            Auto,     // Winograd para 3x3, stride 1 y >= 4 canales; im2col en otro caso
+            Im2col,
+            Winograd  // F(2x2, 3x3); solo forward, backward usa im2col
+        };
+
+        template<typename T>
+        class Conv2D : public ILayer<T> {
+        public:
+            Conv2D(size_t in_channels, size_t in_h, size_t in_w, size_t out_channels,
+                   size_t kernel, size_t stride = 1, size_t padding = 0,
+                   ConvAlgo algo = ConvAlgo::Auto,
+                   uint64_t seed = 42, uint64_t layer_id = AUTO_LAYER_ID)
+              : C(in_channels), H(in_h), W_in(in_w), OC(out_channels),
+                K(kernel), S(stride), P(padding),
+                W(out_channels, in_channels * kernel * kernel),
+                b(out_channels, 1),
+                dW(out_channels, in_channels * kernel * kernel),
+                db(out_channels, 1),
+                seed_(seed),
+                id_automatico(layer_id == AUTO_LAYER_ID)
+            {
+                if (S == 0 || H + 2 * P < K || W_in + 2 * P < K)
+                    throw algebra::TensorError("Invalid Conv2D geometry");
+                OH = (H + 2 * P - K) / S + 1;
+                OW = (W_in + 2 * P - K) / S + 1;
+                // Con pocos canales de entrada la transformacion de Winograd no
+                // se amortiza frente a la GEMM de im2col (ver bench/bench_conv.cpp)
+                usar_winograd = algo == ConvAlgo::Winograd ||
+                                (algo == ConvAlgo::Auto && K == 3 && S == 1 && C >= 4);
+                if (usar_winograd && (K != 3 || S != 1))
+                    throw algebra::TensorError("Winograd path requires 3x3 kernel and stride 1");
+                // Sin id explicito W se llena en add_layer o en el primer uso
+                if (!id_automatico)
+                    inicializar(layer_id);
+                b.fill(0);
+            }
+
+            bool assign_layer_id(uint64_t layer_id) override {
+                if (id_automatico) {
+                    id_automatico = false;
+                    inicializar(layer_id);
+                }
+                return true;
+            }
+
+            size_t out_h() const { return OH; }
+            size_t out_w() const { return OW; }
+            size_t out_features() const { return OC * OH * OW; }
+
+            Tensor2<T> forward(const Tensor2<T>& input) override {
+                return flatten(forward(to_nchw(input, C, H, W_in)));
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                return flatten(backward(to_nchw(grad_output, OC, OH, OW)));
+            }
+
+            Tensor4<T> forward(const Tensor4<T>& x) {
+                check_input(x);
+                preparar();
+                X = x;
+                return usar_winograd ? forward_winograd(x) : forward_im2col(x);
+            }
+
+            Tensor4<T> backward(const Tensor4<T>& grad) {
+                size_t N = X.shape()[0], L = OH * OW;
+                // G: (OC, N*OH*OW), columnas en el mismo orden que im2col
+                Tensor2<T> G(OC, N * L);
+                const T* g = grad.begin();
+                T* gp = G.begin();
+                for (size_t n = 0; n < N; ++n)
+                    for (size_t o = 0; o < OC; ++o)
+                        std::copy(g + (n * OC + o) * L, g + (n * OC + o + 1) * L, gp + o * N * L + n * L);
+
+                auto cols = im2col(X);
+                dW = algebra::matrix_product(G, cols.transpose_2d());
+                db = G.sum(1);
+                auto dcols = algebra::matrix_product(W.transpose_2d(), G);
+                return col2im(dcols, N);
+            }
+
+            void optimize(T lr) override {
+                preparar();
+                W -= dW * lr;
+                b -= db * lr;
+                filtros_validos = false;
+            }
+
+            // Capa nueva con los mismos parametros; X y dW/db no se copian
+            std::unique_ptr<ILayer<T>> clone() const override {
+                auto c = std::make_unique<Conv2D<T>>(C, H, W_in, OC, K, S, P,
+                                                     usar_winograd ? ConvAlgo::Winograd : ConvAlgo::Im2col,
+                                                     seed_);
+                c->W = W;
+                c->b = b;
+                c->id_automatico = id_automatico;
+                c->inicializado = inicializado;
+                c->U_winograd = U_winograd;
+                c->filtros_validos = filtros_validos;
+                return c;
+            }
+
+            void release_cache() override {
+                X = Tensor4<T>();
+            }
+
+            size_t cache_bytes() const override {
+                return X.tamano_total() * sizeof(T);
+            }
+
+            const Tensor2<T>& weights() const {
+                preparar();
+                return W;
+            }
+            const Tensor2<T>& bias() const { return b; }
+            // Gradientes del ultimo backward
+            const Tensor2<T>& grad_weights() const { return dW; }
+            const Tensor2<T>& grad_bias() const { return db; }
+
+        private:
+            void inicializar(uint64_t layer_id) const {
+                algebra::CounterRNG(seed_, layer_id).fill_normal(W, T(0), T(0.1));
+                inicializado = true;
+                filtros_validos = false;
+            }
+
+            void preparar() const {
+                if (!inicializado)
+                    inicializar(0);
+            }
+
+            void check_input(const Tensor4<T>& x) const {
+                const unsigned long* d = x.shape();
+                if (d[1] != C || d[2] != H || d[3] != W_in)
+                    throw algebra::TensorError("Conv2D input shape does not match");
+            }
+
+            // cols: (C*K*K, N*OH*OW). Fila = (c, ky, kx); columna = (n, oy, ox)
+            Tensor2<T> im2col(const Tensor4<T>& x) const {
+                size_t N = x.shape()[0], L = OH * OW;
+                Tensor2<T> cols(C * K * K, N * L);
+                const T* xp = x.begin();
+                T* cp = cols.begin();
+                algebra::parallel_rows(C * K * K, N * L, [&](size_t lo, size_t hi) {
+                    for (size_t r = lo; r < hi; ++r) {
+                        size_t c = r / (K * K), ky = (r / K) % K, kx = r % K;
+                        T* fila = cp + r * N * L;
+                        for (size_t n = 0; n < N; ++n) {
+                            const T* img = xp + (n * C + c) * H * W_in;
+                            for (size_t oy = 0; oy < OH; ++oy) {
+                                long iy = long(oy * S + ky) - long(P);
+                                T* dst = fila + n * L + oy * OW;
+                                if (iy < 0 || iy >= long(H)) {
+                                    std::fill(dst, dst + OW, T(0));
+                                    continue;
+                                }
+                                for (size_t ox = 0; ox < OW; ++ox) {
+                                    long ix = long(ox * S + kx) - long(P);
+                                    dst[ox] = (ix < 0 || ix >= long(W_in)) ? T(0) : img[iy * W_in + ix];
+                                }
+                            }
+                        }
+                    }
+                });
+                return cols;
+            }
+
+            Tensor4<T> col2im(const Tensor2<T>& dcols, size_t N) const {
+                size_t L = OH * OW;
+                Tensor4<T> dx(N, C, H, W_in);
+                const T* cp = dcols.begin();
+                T* dp = dx.begin();
+                // Cada canal acumula solo sobre si mismo: se reparte por canal
+                algebra::parallel_rows(C, K * K * N * L, [&](size_t lo, size_t hi) {
+                    for (size_t c = lo; c < hi; ++c)
+                        for (size_t ky = 0; ky < K; ++ky)
+                            for (size_t kx = 0; kx < K; ++kx) {
+                                const T* fila = cp + ((c * K + ky) * K + kx) * N * L;
+                                for (size_t n = 0; n < N; ++n) {
+                                    T* img = dp + (n * C + c) * H * W_in;
+                                    for (size_t oy = 0; oy < OH; ++oy) {
+                                        long iy = long(oy * S + ky) - long(P);
+                                        if (iy < 0 || iy >= long(H)) continue;
+                                        for (size_t ox = 0; ox < OW; ++ox) {
+                                            long ix = long(ox * S + kx) - long(P);
+                                            if (ix >= 0 && ix < long(W_in))
+                                                img[iy * W_in + ix] += fila[n * L + oy * OW + ox];
+                                        }
+                                    }
+                                }
+                            }
+                });
+                return dx;
+            }
+
+            Tensor4<T> forward_im2col(const Tensor4<T>& x) const {
+                size_t N = x.shape()[0], L = OH * OW;
+                auto Yc = algebra::matrix_product(W, im2col(x));
+                Yc += b;
+                Tensor4<T> y(N, OC, OH, OW);
+                const T* src = Yc.begin();
+                T* yp = y.begin();
+                for (size_t n = 0; n < N; ++n)
+                    for (size_t o = 0; o < OC; ++o)
+                        std::copy(src + o * N * L + n * L, src + o * N * L + (n + 1) * L, yp + (n * OC + o) * L);
+                return y;
+            }
+
+            // U = G g G^T solo depende de W: se calcula una vez y se reusa en
+            // cada forward hasta que optimize() o la inicializacion cambien W.
+            const std::vector<Tensor2<T>>& filtros_winograd() const {
+                if (filtros_validos)
+                    return U_winograd;
+                auto& U = U_winograd;
+                U.assign(16, Tensor2<T>(OC, C));
+                for (size_t o = 0; o < OC; ++o)
+                    for (size_t c = 0; c < C; ++c) {
+                        const T* g = W.begin() + (o * C + c) * 9;
+                        T Gg[4][3], u[4][4];
+                        for (size_t j = 0; j < 3; ++j) {
+                            Gg[0][j] = g[j];
+                            Gg[1][j] = (g[j] + g[3 + j] + g[6 + j]) / T(2);
+                            Gg[2][j] = (g[j] - g[3 + j] + g[6 + j]) / T(2);
+                            Gg[3][j] = g[6 + j];
+                        }
+                        for (size_t i = 0; i < 4; ++i) {
+                            u[i][0] = Gg[i][0];
+                            u[i][1] = (Gg[i][0] + Gg[i][1] + Gg[i][2]) / T(2);
+                            u[i][2] = (Gg[i][0] - Gg[i][1] + Gg[i][2]) / T(2);
+                            u[i][3] = Gg[i][2];
+                        }
+                        for (size_t xi = 0; xi < 16; ++xi)
+                            U[xi](o, c) = u[xi / 4][xi % 4];
+                    }
+                filtros_validos = true;
+                return U;
+            }
+
+            // Winograd F(2x2, 3x3): Y = A^T [ (G g G^T) . (B^T d B) ] A.
+            // Las 16 posiciones del dominio transformado son 16 GEMM
+            // independientes (OC x C) * (C x tiles) que reutilizan matrix_product.
+            Tensor4<T> forward_winograd(const Tensor4<T>& x) const {
+                size_t N = x.shape()[0];
+                size_t TH = (OH + 1) / 2, TW = (OW + 1) / 2, tiles = N * TH * TW;
+                const auto& U = filtros_winograd();
+
+                std::vector<Tensor2<T>> V(16, Tensor2<T>(C, tiles));
+                const T* xp = x.begin();
+                algebra::parallel_rows(N * C, 16 * TH * TW, [&](size_t lo, size_t hi) {
+                    for (size_t nc = lo; nc < hi; ++nc) {
+                        size_t n = nc / C, c = nc % C;
+                        const T* img = xp + nc * H * W_in;
+                        for (size_t ty = 0; ty < TH; ++ty)
+                            for (size_t tx = 0; tx < TW; ++tx) {
+                                T d[4][4], t[4][4];
+                                for (size_t i = 0; i < 4; ++i)
+                                    for (size_t j = 0; j < 4; ++j) {
+                                        long iy = long(ty * 2 + i) - long(P);
+                                        long ix = long(tx * 2 + j) - long(P);
+                                        d[i][j] = (iy < 0 || iy >= long(H) || ix < 0 || ix >= long(W_in))
+                                                  ? T(0) : img[iy * W_in + ix];
+                                    }
+                                for (size_t j = 0; j < 4; ++j) {
+                                    t[0][j] = d[0][j] - d[2][j];
+                                    t[1][j] = d[1][j] + d[2][j];
+                                    t[2][j] = d[2][j] - d[1][j];
+                                    t[3][j] = d[1][j] - d[3][j];
+                                }
+                                size_t pos = c * tiles + (n * TH + ty) * TW + tx;
+                                for (size_t i = 0; i < 4; ++i) {
+                                    V[i * 4 + 0].begin()[pos] = t[i][0] - t[i][2];
+                                    V[i * 4 + 1].begin()[pos] = t[i][1] + t[i][2];
+                                    V[i * 4 + 2].begin()[pos] = t[i][2] - t[i][1];
+                                    V[i * 4 + 3].begin()[pos] = t[i][1] - t[i][3];
+                                }
+                            }
+                    }
+                });
+
+                std::vector<Tensor2<T>> M;
+                M.reserve(16);
+                for (size_t xi = 0; xi < 16; ++xi)
+                    M.push_back(algebra::matrix_product(U[xi], V[xi]));
+
+                Tensor4<T> y(N, OC, OH, OW);
+                T* yp = y.begin();
+                const T* mp[16];
+                for (size_t xi = 0; xi < 16; ++xi)
+                    mp[xi] = M[xi].begin();
+                algebra::parallel_rows(OC, 16 * tiles, [&](size_t lo, size_t hi) {
+                    for (size_t o = lo; o < hi; ++o) {
+                        T bias_o = b.begin()[o];
+                        for (size_t col = 0; col < tiles; ++col) {
+                            size_t n = col / (TH * TW), ty = (col / TW) % TH, tx = col % TW;
+                            T m[4][4], a[2][4];
+                            for (size_t xi = 0; xi < 16; ++xi)
+                                m[xi / 4][xi % 4] = mp[xi][o * tiles + col];
+                            for (size_t j = 0; j < 4; ++j) {
+                                a[0][j] = m[0][j] + m[1][j] + m[2][j];
+                                a[1][j] = m[1][j] - m[2][j] - m[3][j];
+                            }
+                            for (size_t i = 0; i < 2; ++i) {
+                                size_t oy = ty * 2 + i;
+                                if (oy >= OH) continue;
+                                T r0 = a[i][0] + a[i][1] + a[i][2];
+                                T r1 = a[i][1] - a[i][2] - a[i][3];
+                                T* dst = yp + ((n * OC + o) * OH + oy) * OW;
+                                dst[tx * 2] = r0 + bias_o;
+                                if (tx * 2 + 1 < OW) dst[tx * 2 + 1] = r1 + bias_o;
+                            }
+                        }
+                    }
+                });
+                return y;
+            }
+
+            size_t C, H, W_in, OC, K, S, P;
+            size_t OH, OW;
+            bool usar_winograd;
+            mutable Tensor2<T> W;
+            Tensor2<T> b;
+            Tensor2<T> dW, db;
+            Tensor4<T> X;
+            uint64_t seed_;
+            bool id_automatico;
+            mutable bool inicializado = false;
+            mutable std::vector<Tensor2<T>> U_winograd;
+            mutable bool filtros_validos = false;
+        };
+
+        template<typename T>
+        class MaxPool2D : public ILayer<T> {
+        public:
+            MaxPool2D(size_t channels, size_t in_h, size_t in_w, size_t kernel, size_t stride = 0)
+              : C(channels), H(in_h), W_in(in_w), K(kernel), S(stride == 0 ? kernel : stride)
+            {
+                if (K == 0 || H < K || W_in < K)
+                    throw algebra::TensorError("Invalid MaxPool2D geometry");
+                OH = (H - K) / S + 1;
+                OW = (W_in - K) / S + 1;
+            }
+
+            size_t out_h() const { return OH; }
+            size_t out_w() const { return OW; }
+            size_t out_features() const { return C * OH * OW; }
+
+            Tensor2<T> forward(const Tensor2<T>& input) override {
+                return flatten(forward(to_nchw(input, C, H, W_in)));
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                return flatten(backward(to_nchw(grad_output, C, OH, OW)));
+            }
+
+            Tensor4<T> forward(const Tensor4<T>& x) {
+                size_t N = x.shape()[0];
+                if (x.shape()[1] != C || x.shape()[2] != H || x.shape()[3] != W_in)
+                    throw algebra::TensorError("MaxPool2D input shape does not match");
+                Tensor4<T> y(N, C, OH, OW);
+                argmax.assign(N * C * OH * OW, 0);
+                batch = N;
+                const T* xp = x.begin();
+                T* yp = y.begin();
+                for (size_t nc = 0; nc < N * C; ++nc) {
+                    const T* img = xp + nc * H * W_in;
+                    for (size_t oy = 0; oy < OH; ++oy)
+                        for (size_t ox = 0; ox < OW; ++ox) {
+                            size_t mejor = (oy * S) * W_in + ox * S;
+                            for (size_t ky = 0; ky < K; ++ky)
+                                for (size_t kx = 0; kx < K; ++kx) {
+                                    size_t idx = (oy * S + ky) * W_in + ox * S + kx;
+                                    if (img[idx] > img[mejor]) mejor = idx;
+                                }
+                            size_t o = (nc * OH + oy) * OW + ox;
+                            yp[o] = img[mejor];
+                            argmax[o] = nc * H * W_in + mejor;
+                        }
+                }
+                return y;
+            }
+
+            Tensor4<T> backward(const Tensor4<T>& grad) {
+                Tensor4<T> dx(batch, C, H, W_in);
+                const T* g = grad.begin();
+                T* dp = dx.begin();
+                for (size_t o = 0; o < argmax.size(); ++o)
+                    dp[argmax[o]] += g[o];
+                return dx;
+            }
+
+            std::unique_ptr<ILayer<T>> clone() const override {
+                return std::make_unique<MaxPool2D<T>>(C, H, W_in, K, S);
+            }
+
+            void release_cache() override {
+                argmax = std::vector<size_t>();
+            }
+
+            size_t cache_bytes() const override {
+                return argmax.size() * sizeof(size_t);
+            }
+
+        private:
+            size_t C, H, W_in, K, S;
+            size_t OH, OW;
+            size_t batch = 0;
+            std::vector<size_t> argmax;
+        };
+
+        // En la ruta Tensor2 las filas ya estan aplanadas, asi que Flatten solo
+        // valida el tamano; la version Tensor4 hace el paso NCHW -> (N, C*H*W).
+        template<typename T>
+        class Flatten : public ILayer<T> {
+        public:
+            Flatten(size_t channels, size_t h, size_t w) : features(channels * h * w) {}
+
+            Tensor2<T> forward(const Tensor2<T>& input) override {
+                if (input.shape()[1] != features)
+                    throw algebra::TensorError("Flatten input size does not match");
+                return input;
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                return grad_output;
+            }
+
+            Tensor2<T> forward(const Tensor4<T>& x) {
+                return flatten(x);
+            }
+
+            std::unique_ptr<ILayer<T>> clone() const override {
+                return std::make_unique<Flatten<T>>(*this);
+            }
+
+        private:
+            size_t features;
+        };
+
+    } // namespace nn
+} // namespace utec
@@ -1,6 +1,7 @@
 #pragma once
-#include <random>
+#include <cstdint>
 #include "Tensor.h"
+#include "Random.h"
 #include "layer.h"
 
 namespace utec {
@@ -9,27 +10,38 @@ namespace utec {
         template<typename T>
         class Dense : public ILayer<T> {
         public:
-            Dense(size_t in_features, size_t out_features)
+            // W(i) depende solo de (seed, layer_id, i): la inicializacion se
+            // reparte entre hilos y es reproducible bit a bit. Sin id explicito
+            // W se llena una sola vez: en add_layer o, fuera de una red, en el
+            // primer uso con el stream 0.
+            Dense(size_t in_features, size_t out_features,
+                  uint64_t seed = 42, uint64_t layer_id = AUTO_LAYER_ID)
               : W(in_features, out_features),
                 b(1, out_features),
                 dW(in_features, out_features),
-                db(1, out_features)
+                db(1, out_features),
+                seed_(seed),
+                id_automatico(layer_id == AUTO_LAYER_ID)
             {
-                std::mt19937 gen(42);
-                std::normal_distribution<T> dist(0.0, 0.1);
-                for (auto& v : W) v = dist(gen);
+                if (!id_automatico)
+                    inicializar(layer_id);
                 b.fill(0);
             }
 
+            bool assign_layer_id(uint64_t layer_id) override {
+                if (id_automatico) {
+                    id_automatico = false;
+                    inicializar(layer_id);
+                }
+                return true;
+            }
+
             Tensor2<T> forward(const Tensor2<T>& input) override {
+                preparar();
                 X = input;
                 auto Y = algebra::matrix_product(X, W);
-                // Broadcasting para sumar bias
-                for (size_t i = 0; i < Y.shape()[0]; ++i) {
-                    for (size_t j = 0; j < Y.shape()[1]; ++j) {
-                        Y(i, j) += b(0, j);
-                    }
-                }
+                // Broadcasting para sumar bias: (n, out) += (1, out)
+                Y += b;
                 return Y;
             }
 
@@ -37,32 +49,60 @@ namespace utec {
                 auto XT = X.transpose_2d();
                 dW = algebra::matrix_product(XT, grad_output);
 
-                for (size_t j = 0; j < grad_output.shape()[1]; ++j) {
-                    T sum = 0;
-                    for (size_t i = 0; i < grad_output.shape()[0]; ++i)
-                        sum += grad_output(i, j);
-                    db(0, j) = sum;
-                }
+                db = grad_output.sum(0);
 
                 auto WT = W.transpose_2d();
                 return algebra::matrix_product(grad_output, WT);
             }
 
-            void optimize(T lr) {
-                for (size_t i = 0; i < W.shape()[0]; ++i) {
-                    for (size_t j = 0; j < W.shape()[1]; ++j) {
-                        W(i, j) -= lr * dW(i, j);
-                    }
-                }
-                for (size_t j = 0; j < b.shape()[1]; ++j) {
-                    b(0, j) -= lr * db(0, j);
-                }
+            // Capa nueva con los mismos parametros; X y dW/db no se copian
+            std::unique_ptr<ILayer<T>> clone() const override {
+                auto c = std::make_unique<Dense<T>>(W.shape()[0], W.shape()[1], seed_);
+                c->W = W;
+                c->b = b;
+                c->id_automatico = id_automatico;
+                c->inicializado = inicializado;
+                return c;
             }
 
+            void release_cache() override {
+                X = Tensor2<T>();
+            }
+
+            size_t cache_bytes() const override {
+                return X.tamano_total() * sizeof(T);
+            }
+
+            void optimize(T lr) override {
+                preparar();
+                W -= dW * lr;
+                b -= db * lr;
+            }
+
+            const Tensor2<T>& weights() const {
+                preparar();
+                return W;
+            }
+            const Tensor2<T>& bias() const { return b; }
+
         private:
-            Tensor2<T> W, b;
+            void inicializar(uint64_t layer_id) const {
+                algebra::CounterRNG(seed_, layer_id).fill_normal(W, T(0), T(0.1));
+                inicializado = true;
+            }
+
+            void preparar() const {
+                if (!inicializado)
+                    inicializar(0);
+            }
+
+            mutable Tensor2<T> W;
+            Tensor2<T> b;
             Tensor2<T> X;
             Tensor2<T> dW, db;
+            uint64_t seed_;
+            bool id_automatico;
+            mutable bool inicializado = false;
         };
 
     } // namespace nn
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include "Tensor.h"
+#include "Random.h"
+#include "layer.h"
+
+namespace utec {
+    namespace nn {
+
+        // Dropout invertido. La mascara del elemento i en el paso s sale de
+        // Philox con contador (s, i): no hay estado compartido entre hilos y
+        // el recalculo del checkpointing reproduce la misma mascara, porque
+        // el paso solo avanza en backward. Cada Dropout de una red recibe su
+        // propio stream; uno suelto sin id usa AUTO_LAYER_ID, que no coincide
+        // con ninguno de los que asigna add_layer.
+        template<typename T>
+        class Dropout : public ILayer<T> {
+        public:
+            explicit Dropout(T p, uint64_t seed = 42, uint64_t layer_id = AUTO_LAYER_ID)
+              : prob(p), rng(seed, STREAM_BIT | layer_id),
+                seed_(seed), id_automatico(layer_id == AUTO_LAYER_ID)
+            {
+                if (prob < T(0) || prob >= T(1))
+                    throw algebra::TensorError("Dropout probability must be in [0, 1)");
+            }
+
+            void set_training(bool training) override { entrenando = training; }
+
+            Tensor2<T> forward(const Tensor2<T>& x) override {
+                if (!entrenando || prob == T(0)) {
+                    mask = Tensor2<T>();
+                    return x;
+                }
+                mask = Tensor2<T>(x.shape()[0], x.shape()[1]);
+                rng.fill_uniform(mask, T(0), T(1), paso << 32);
+                T escala = T(1) / (T(1) - prob);
+                T p = prob;
+                mask = mask.apply([p, escala](T u) { return u < p ? T(0) : escala; });
+                return x * mask;
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                ++paso;
+                if (mask.tamano_total() == 0)
+                    return grad_output;
+                return grad_output * mask;
+            }
+
+            // Sin parametros: no consume id de capa sino uno de la numeracion
+            // de streams, separada de la de inicializacion por STREAM_BIT.
+            bool assign_stream_id(uint64_t stream_id) override {
+                if (id_automatico) {
+                    id_automatico = false;
+                    rng = algebra::CounterRNG(seed_, STREAM_BIT | stream_id);
+                }
+                return true;
+            }
+
+            // Mismo stream y paso, sin la mascara del ultimo forward
+            std::unique_ptr<ILayer<T>> clone() const override {
+                auto c = std::make_unique<Dropout<T>>(prob, seed_);
+                c->rng = rng;
+                c->id_automatico = id_automatico;
+                c->entrenando = entrenando;
+                c->paso = paso;
+                return c;
+            }
+
+            void release_cache() override {
+                mask = Tensor2<T>();
+            }
+
+            size_t cache_bytes() const override {
+                return mask.tamano_total() * sizeof(T);
+            }
+
+        private:
+            static constexpr uint64_t STREAM_BIT = uint64_t(1) << 63;
+
+            T prob;
+            algebra::CounterRNG rng;
+            uint64_t seed_;
+            bool id_automatico;
+            bool entrenando = true;
+            uint64_t paso = 0;
+            Tensor2<T> mask;
+        };
+
+    } // namespace nn
+} // namespace utec
@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <cstdint>
 #include "Tensor.h"
 
 namespace utec {
@@ -8,12 +9,40 @@ namespace utec {
         template<typename T>
         using Tensor2 = algebra::Tensor<T, 2>;
 
+        // Capa sin id explicito: NeuralNetwork::add_layer le asigna uno
+        constexpr uint64_t AUTO_LAYER_ID = ~uint64_t(0);
+
         template<typename T>
         class ILayer {
         public:
             virtual ~ILayer() = default;
             virtual Tensor2<T> forward(const Tensor2<T>& input) = 0;
             virtual Tensor2<T> backward(const Tensor2<T>& grad_output) = 0;
+
+            // Libera lo guardado en forward para el backward (checkpointing)
+            virtual void release_cache() {}
+            virtual size_t cache_bytes() const { return 0; }
+
+            // Capas sin parametros no hacen nada
+            virtual void optimize(T /*lr*/) {}
+
+            // NeuralNetwork numera sus capas con parametros (0, 1, ...) para
+            // que cada una use su propio stream de inicializacion. Devuelve
+            // false si la capa no tiene parametros.
+            virtual bool assign_layer_id(uint64_t /*layer_id*/) { return false; }
+
+            // Las capas sin parametros pero con azar propio (Dropout) llevan
+            // otra numeracion, asi dos seguidas no comparten stream. Devuelve
+            // false si la capa no usa numeros aleatorios.
+            virtual bool assign_stream_id(uint64_t /*stream_id*/) { return false; }
+
+            // Copia independiente de los parametros, sin caches ni gradientes,
+            // para validar en otro hilo mientras se sigue entrenando. nullptr
+            // si la capa no se puede copiar.
+            virtual std::unique_ptr<ILayer<T>> clone() const { return nullptr; }
+
+            // Solo cambia el comportamiento de capas como Dropout
+            virtual void set_training(bool /*training*/) {}
         };
 
     } // namespace nn
@@ -1,10 +1,15 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <future>
+#include <chrono>
 #include "Tensor.h"
 #include "layer.h"
 #include "dense.h"
+#include "sparse_dense.h"
 #include "loss.h"
+#include "training.h"
 
 namespace utec {
     namespace nn {
@@ -15,45 +20,238 @@ namespace utec {
             using LayerPtr = std::unique_ptr<ILayer<T>>;
 
             void add_layer(LayerPtr l) {
+                if (l->assign_layer_id(next_layer_id))
+                    ++next_layer_id;
+                if (l->assign_stream_id(next_stream_id))
+                    ++next_stream_id;
                 layers.push_back(std::move(l));
             }
 
+            // Checkpointing: solo se guardan las entradas de cada segmento de
+            // `segment_size` capas y el resto se recalcula en backward.
+            // segment_size = 0 lo desactiva.
+            // Aplica desde el siguiente forward; backward sigue el modo con
+            // el que corrio el ultimo forward.
+            void enable_checkpointing(size_t segment_size) {
+                checkpoint_segment = segment_size;
+            }
+
+            // Reemplaza cada Dense entrenada por su version podada en CSR
+            void sparsify(PruneMode mode, T sparsity = T(0.5)) {
+                for (auto& l : layers) {
+                    if (auto* d = dynamic_cast<Dense<T>*>(l.get())) {
+                        bytes_vivos -= l->cache_bytes();
+                        l = std::make_unique<SparseDense<T>>(*d, mode, sparsity);
+                    }
+                }
+            }
+
+            size_t num_layers() const { return layers.size(); }
+            const ILayer<T>& layer(size_t i) const { return *layers.at(i); }
+
+            size_t peak_activation_bytes() const { return peak_bytes; }
+            void reset_activation_stats() { peak_bytes = 0; }
+
             Tensor2<T> forward(const Tensor2<T>& X) const {
+                forward_segment = checkpoint_segment;
+                clear_checkpoints();
+                if (checkpoint_segment == 0) {
+                    auto out = X;
+                    for (size_t i = 0; i < layers.size(); ++i)
+                        out = forward_layer(i, out);
+                    return out;
+                }
+
+                size_t last_begin = last_segment_begin(checkpoint_segment);
                 auto out = X;
-                for (auto& l : layers)
-                    out = l->forward(out);
+                for (size_t i = 0; i < layers.size(); ++i) {
+                    if (i % checkpoint_segment == 0 && i < last_begin) {
+                        checkpoints.push_back(out);
+                        bytes_vivos += out.tamano_total() * sizeof(T);
+                    }
+                    out = forward_layer(i, out);
+                    // El ultimo segmento conserva su cache: se usa de inmediato en backward
+                    if (i < last_begin)
+                        release_layer(i);
+                }
                 return out;
             }
 
-            void backward(const Tensor2<T>& Y_pred, const Tensor2<T>& Y_true) {
+            // Devuelve la perdida que ya calcula para el gradiente
+            T backward(const Tensor2<T>& Y_pred, const Tensor2<T>& Y_true) {
                 T loss = criterion.forward(Y_pred, Y_true);
                 auto grad = criterion.backward();
-                for (auto it = layers.rbegin(); it != layers.rend(); ++it)
-                    grad = (*it)->backward(grad);
+                size_t seg = forward_segment;
+                if (seg == 0) {
+                    for (size_t i = layers.size(); i-- > 0; )
+                        grad = backward_layer(i, grad);
+                    return loss;
+                }
+
+                size_t end = layers.size();
+                size_t begin = last_segment_begin(seg);
+                if (checkpoints.size() != begin / seg)
+                    throw algebra::TensorError("NeuralNetwork::backward needs a checkpointed forward first");
+                while (end > 0) {
+                    if (end != layers.size()) {
+                        // Recalcula las activaciones del segmento desde su checkpoint
+                        auto out = checkpoints[begin / seg];
+                        for (size_t i = begin; i < end; ++i)
+                            out = forward_layer(i, out);
+                        bytes_vivos -= checkpoints[begin / seg].tamano_total() * sizeof(T);
+                        checkpoints[begin / seg] = Tensor2<T>();
+                    }
+                    for (size_t i = end; i-- > begin; ) {
+                        grad = backward_layer(i, grad);
+                        release_layer(i);
+                    }
+                    end = begin;
+                    begin = end >= seg ? end - seg : 0;
+                }
+                clear_checkpoints();
+                return loss;
             }
 
             void optimize(T lr) {
+                for (auto& l : layers)
+                    l->optimize(lr);
+            }
+
+            void set_training(bool training) {
+                for (auto& l : layers)
+                    l->set_training(training);
+            }
+
+            T evaluate(const Tensor2<T>& X, const Tensor2<T>& Y) const {
+                MSELoss<T> mse;
+                T loss = mse.forward(forward(X), Y);
+                for (size_t i = 0; i < layers.size(); ++i)
+                    release_layer(i);
+                return loss;
+            }
+
+            // Copia independiente de la red o nullptr si alguna capa no se puede copiar
+            std::unique_ptr<NeuralNetwork> clone() const {
+                auto copia = std::make_unique<NeuralNetwork>();
                 for (auto& l : layers) {
-                    if (auto* d = dynamic_cast<Dense<T>*>(l.get()))
-                        d->optimize(lr);
+                    auto c = l->clone();
+                    if (!c) return nullptr;
+                    copia->layers.push_back(std::move(c));
                 }
+                copia->next_layer_id = next_layer_id;
+                copia->next_stream_id = next_stream_id;
+                return copia;
             }
 
             void train(const Tensor2<T>& X, const Tensor2<T>& Y, size_t epochs, T lr) {
-                for (size_t e = 0; e < epochs; ++e) {
+                MetricsLogger<T> logger(std::cout, 500);
+                train(X, Y, epochs, lr, {&logger});
+            }
+
+            // Devuelve el numero de epocas ejecutadas. Con X_val/Y_val, cada
+            // `val_every` epocas se evalua una copia de los pesos en otro hilo
+            // mientras sigue el entrenamiento (si ya hay una evaluacion en curso
+            // se omite esa). La copia evalua en modo inferencia; si alguna
+            // capa no implementa clone() la validacion se hace en el mismo hilo.
+            size_t train(const Tensor2<T>& X, const Tensor2<T>& Y, size_t epochs, T lr,
+                         const std::vector<TrainingCallback<T>*>& callbacks,
+                         const Tensor2<T>* X_val = nullptr, const Tensor2<T>* Y_val = nullptr,
+                         size_t val_every = 1) {
+                bool validar = X_val && Y_val;
+                if (val_every == 0) val_every = 1;
+                for (auto* cb : callbacks)
+                    cb->on_train_begin(validar);
+
+                TrainControl<T> ctl{lr};
+                std::future<T> pendiente;
+                size_t epoca_validada = 0;
+                auto entregar = [&](T val_loss) {
+                    for (auto* cb : callbacks)
+                        cb->on_validation(epoca_validada, val_loss, ctl);
+                };
+
+                size_t e = 0;
+                while (e < epochs && !ctl.stop) {
                     auto Y_pred = forward(X);
-                    backward(Y_pred, Y);
-                    optimize(lr);
-                    if (e % 500 == 0) {
-                        T loss = criterion.forward(Y_pred, Y);
-                        std::cout << "Epoch " << e << ", Loss: " << loss << std::endl;
+                    EpochMetrics<T> m;
+                    m.epoch = e;
+                    m.train_loss = backward(Y_pred, Y);
+                    m.lr = ctl.lr;
+                    optimize(ctl.lr);
+
+                    if (pendiente.valid() &&
+                        pendiente.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                        entregar(pendiente.get());
+                    if (validar && !pendiente.valid() && e % val_every == 0) {
+                        epoca_validada = e;
+                        if (auto copia = clone()) {
+                            copia->set_training(false);
+                            std::shared_ptr<NeuralNetwork> red(std::move(copia));
+                            pendiente = std::async(std::launch::async, [red, X_val, Y_val] {
+                                return red->evaluate(*X_val, *Y_val);
+                            });
+                        } else {
+                            set_training(false);
+                            entregar(evaluate(*X_val, *Y_val));
+                            set_training(true);
+                        }
                     }
+
+                    for (auto* cb : callbacks)
+                        cb->on_epoch_end(m, ctl);
+                    ++e;
                 }
+
+                if (pendiente.valid())
+                    entregar(pendiente.get());
+                for (auto* cb : callbacks)
+                    cb->on_train_end();
+                return e;
             }
 
         private:
+            size_t last_segment_begin(size_t seg) const {
+                if (layers.empty()) return 0;
+                return ((layers.size() - 1) / seg) * seg;
+            }
+
+            // bytes_vivos lleva la suma de caches y checkpoints al dia: cada
+            // paso solo mide la capa que toca, sin recorrer la red entera.
+            Tensor2<T> forward_layer(size_t i, const Tensor2<T>& in) const {
+                size_t antes = layers[i]->cache_bytes();
+                auto out = layers[i]->forward(in);
+                bytes_vivos = bytes_vivos - antes + layers[i]->cache_bytes();
+                peak_bytes = std::max(peak_bytes, bytes_vivos);
+                return out;
+            }
+
+            Tensor2<T> backward_layer(size_t i, const Tensor2<T>& grad) {
+                size_t antes = layers[i]->cache_bytes();
+                auto out = layers[i]->backward(grad);
+                bytes_vivos = bytes_vivos - antes + layers[i]->cache_bytes();
+                return out;
+            }
+
+            void release_layer(size_t i) const {
+                bytes_vivos -= layers[i]->cache_bytes();
+                layers[i]->release_cache();
+            }
+
+            void clear_checkpoints() const {
+                for (auto& c : checkpoints)
+                    bytes_vivos -= c.tamano_total() * sizeof(T);
+                checkpoints.clear();
+            }
+
             std::vector<LayerPtr> layers;
             MSELoss<T> criterion;
+            size_t checkpoint_segment = 0;
+            uint64_t next_layer_id = 0;
+            uint64_t next_stream_id = 0;
+            mutable size_t forward_segment = 0;
+            mutable std::vector<Tensor2<T>> checkpoints;
+            mutable size_t peak_bytes = 0;
+            mutable size_t bytes_vivos = 0;
         };
 
     } // namespace nn
@@ -0,0 +1,255 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Tensor.h"
+#include "ThreadPool.h"
+#include "layer.h"
+#include "dense.h"
+
+namespace utec {
+    namespace nn {
+
+        enum class PruneMode {
+            Magnitude,      // elimina la fraccion `sparsity` de pesos con menor |w|
+            Structured2of4  // en cada grupo de 4 entradas consecutivas deja las 2 mayores
+        };
+
+        // Devuelve W con los pesos podados puestos a cero.
+        template<typename T>
+        Tensor2<T> prune_magnitude(const Tensor2<T>& W, T sparsity) {
+            Tensor2<T> P = W;
+            size_t total = W.tamano_total();
+            size_t eliminar = static_cast<size_t>(std::floor(sparsity * T(total)));
+            if (eliminar == 0) return P;
+            if (eliminar >= total) {
+                P.fill(T(0));
+                return P;
+            }
+            std::vector<size_t> orden(total);
+            for (size_t i = 0; i < total; ++i) orden[i] = i;
+            const T* w = W.begin();
+            std::nth_element(orden.begin(), orden.begin() + eliminar, orden.end(),
+                             [w](size_t a, size_t b) { return std::abs(w[a]) < std::abs(w[b]); });
+            T* p = P.begin();
+            for (size_t i = 0; i < eliminar; ++i)
+                p[orden[i]] = T(0);
+            return P;
+        }
+
+        // 2:4 sobre la dimension de entrada (la que se reduce en el producto):
+        // por cada neurona de salida j, grupos W(k..k+3, j).
+        template<typename T>
+        Tensor2<T> prune_2_of_4(const Tensor2<T>& W) {
+            Tensor2<T> P = W;
+            size_t in = W.shape()[0], out = W.shape()[1];
+            for (size_t j = 0; j < out; ++j) {
+                for (size_t k0 = 0; k0 < in; k0 += 4) {
+                    size_t n = std::min<size_t>(4, in - k0);
+                    if (n <= 2) continue;
+                    // Las dos entradas de mayor magnitud del grupo
+                    size_t m1 = k0, m2 = k0 + 1;
+                    if (std::abs(W(m2, j)) > std::abs(W(m1, j))) std::swap(m1, m2);
+                    for (size_t k = k0 + 2; k < k0 + n; ++k) {
+                        if (std::abs(W(k, j)) > std::abs(W(m1, j))) { m2 = m1; m1 = k; }
+                        else if (std::abs(W(k, j)) > std::abs(W(m2, j))) m2 = k;
+                    }
+                    for (size_t k = k0; k < k0 + n; ++k)
+                        if (k != m1 && k != m2) P(k, j) = T(0);
+                }
+            }
+            return P;
+        }
+
+        // Capa densa con pesos podados en formato CSR. Se guarda W^T por filas
+        // (una fila por neurona de salida) y un indice traspuesto que apunta a
+        // los mismos valores, asi forward y backward recorren filas contiguas.
+        // El lote va en la dimension contigua: los bucles internos son axpy/dot
+        // de longitud `batch` sin saltos, que el compilador vectoriza.
+        template<typename T>
+        class SparseDense : public ILayer<T> {
+        public:
+            SparseDense(const Tensor2<T>& W, const Tensor2<T>& bias)
+              : in_features(W.shape()[0]),
+                out_features(W.shape()[1]),
+                b(bias),
+                db(1, W.shape()[1])
+            {
+                build_csr(W);
+            }
+
+            SparseDense(const Dense<T>& dense, PruneMode mode, T sparsity = T(0.5))
+              : SparseDense(mode == PruneMode::Structured2of4
+                                ? prune_2_of_4(dense.weights())
+                                : prune_magnitude(dense.weights(), sparsity),
+                            dense.bias()) {}
+
+            Tensor2<T> forward(const Tensor2<T>& input) override {
+                size_t batch = input.shape()[0];
+                if (input.shape()[1] != in_features)
+                    throw algebra::TensorError("SparseDense: input features do not match");
+                Xt = transpose(input);
+
+                Tensor2<T> Yt(out_features, batch);
+                const T* xt = Xt.begin();
+                T* yt = Yt.begin();
+                por_filas(out_features, batch, [&](size_t lo, size_t hi) {
+                    for (size_t j = lo; j < hi; ++j) {
+                        T* __restrict y = yt + j * batch;
+                        for (size_t p = row_ptr[j]; p < row_ptr[j + 1]; ++p) {
+                            const T v = values[p];
+                            const T* __restrict x = xt + col_idx[p] * batch;
+                            for (size_t i = 0; i < batch; ++i)
+                                y[i] += v * x[i];
+                        }
+                    }
+                });
+
+                auto Y = transpose(Yt);
+                Y += b;
+                return Y;
+            }
+
+            Tensor2<T> backward(const Tensor2<T>& grad_output) override {
+                size_t batch = grad_output.shape()[0];
+                auto Gt = transpose(grad_output);
+                const T* gt = Gt.begin();
+                const T* xt = Xt.begin();
+
+                // dW solo en las posiciones que sobreviven a la poda
+                por_filas(out_features, batch, [&](size_t lo, size_t hi) {
+                    for (size_t j = lo; j < hi; ++j) {
+                        const T* __restrict g = gt + j * batch;
+                        T sb = T(0);
+                        for (size_t i = 0; i < batch; ++i)
+                            sb += g[i];
+                        db(0, j) = sb;
+                        for (size_t p = row_ptr[j]; p < row_ptr[j + 1]; ++p) {
+                            const T* __restrict x = xt + col_idx[p] * batch;
+                            T s = T(0);
+                            for (size_t i = 0; i < batch; ++i)
+                                s += x[i] * g[i];
+                            dvalues[p] = s;
+                        }
+                    }
+                });
+
+                Tensor2<T> dXt(in_features, batch);
+                T* dxt = dXt.begin();
+                por_filas(in_features, batch, [&](size_t lo, size_t hi) {
+                    for (size_t k = lo; k < hi; ++k) {
+                        T* __restrict dx = dxt + k * batch;
+                        for (size_t q = t_row_ptr[k]; q < t_row_ptr[k + 1]; ++q) {
+                            const T v = values[t_pos[q]];
+                            const T* __restrict g = gt + t_col_idx[q] * batch;
+                            for (size_t i = 0; i < batch; ++i)
+                                dx[i] += v * g[i];
+                        }
+                    }
+                });
+                return transpose(dXt);
+            }
+
+            void optimize(T lr) override {
+                for (size_t p = 0; p < values.size(); ++p)
+                    values[p] -= lr * dvalues[p];
+                b -= db * lr;
+            }
+
+            // Copia la estructura CSR y los pesos; Xt y los gradientes no
+            std::unique_ptr<ILayer<T>> clone() const override {
+                return std::unique_ptr<SparseDense<T>>(new SparseDense<T>(*this, SoloParametros{}));
+            }
+
+            void release_cache() override {
+                Xt = Tensor2<T>();
+            }
+
+            size_t cache_bytes() const override {
+                return Xt.tamano_total() * sizeof(T);
+            }
+
+            size_t nnz() const { return values.size(); }
+
+            T density() const {
+                return T(values.size()) / T(in_features * out_features);
+            }
+
+            Tensor2<T> to_dense() const {
+                Tensor2<T> W(in_features, out_features);
+                for (size_t j = 0; j < out_features; ++j)
+                    for (size_t p = row_ptr[j]; p < row_ptr[j + 1]; ++p)
+                        W(col_idx[p], j) = values[p];
+                return W;
+            }
+
+            const Tensor2<T>& bias() const { return b; }
+
+        private:
+            struct SoloParametros {};
+
+            SparseDense(const SparseDense& o, SoloParametros)
+              : in_features(o.in_features), out_features(o.out_features),
+                row_ptr(o.row_ptr), col_idx(o.col_idx),
+                values(o.values), dvalues(o.values.size(), T(0)),
+                t_row_ptr(o.t_row_ptr), t_col_idx(o.t_col_idx), t_pos(o.t_pos),
+                b(o.b), db(1, o.out_features) {}
+
+            void build_csr(const Tensor2<T>& W) {
+                row_ptr.assign(out_features + 1, 0);
+                for (size_t j = 0; j < out_features; ++j) {
+                    for (size_t k = 0; k < in_features; ++k) {
+                        if (W(k, j) != T(0)) {
+                            col_idx.push_back(k);
+                            values.push_back(W(k, j));
+                        }
+                    }
+                    row_ptr[j + 1] = values.size();
+                }
+                dvalues.assign(values.size(), T(0));
+
+                // Indice traspuesto (filas = entradas) que apunta a `values`
+                t_row_ptr.assign(in_features + 1, 0);
+                for (size_t p = 0; p < col_idx.size(); ++p)
+                    t_row_ptr[col_idx[p] + 1]++;
+                for (size_t k = 0; k < in_features; ++k)
+                    t_row_ptr[k + 1] += t_row_ptr[k];
+                t_col_idx.resize(values.size());
+                t_pos.resize(values.size());
+                std::vector<size_t> siguiente(t_row_ptr.begin(), t_row_ptr.end() - 1);
+                for (size_t j = 0; j < out_features; ++j) {
+                    for (size_t p = row_ptr[j]; p < row_ptr[j + 1]; ++p) {
+                        size_t q = siguiente[col_idx[p]]++;
+                        t_col_idx[q] = j;
+                        t_pos[q] = p;
+                    }
+                }
+            }
+
+            template<typename Func>
+            void por_filas(size_t filas, size_t batch, Func f) const {
+                size_t nnz_fila = values.size() / std::max<size_t>(1, filas) + 1;
+                algebra::parallel_rows(filas, batch * nnz_fila, f);
+            }
+
+            static Tensor2<T> transpose(const Tensor2<T>& A) {
+                size_t R = A.shape()[0], C = A.shape()[1];
+                Tensor2<T> At(C, R);
+                const T* a = A.begin();
+                T* at = At.begin();
+                for (size_t i = 0; i < R; ++i)
+                    for (size_t j = 0; j < C; ++j)
+                        at[j * R + i] = a[i * C + j];
+                return At;
+            }
+
+            size_t in_features, out_features;
+            std::vector<size_t> row_ptr, col_idx;
+            std::vector<T> values, dvalues;
+            std::vector<size_t> t_row_ptr, t_col_idx, t_pos;
+            Tensor2<T> b, db;
+            Tensor2<T> Xt;
+        };
+
+    } // namespace nn
+} // namespace utec
@@ -0,0 +1,238 @@
+#pragma once
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include "SpscQueue.h"
+
+namespace utec {
+    namespace nn {
+
+        // Lo que train() ya calculo en la epoca: no se recalcula nada para reportarlo
+        template<typename T>
+        struct EpochMetrics {
+            size_t epoch = 0;
+            T train_loss = T(0);
+            T lr = T(0);
+        };
+
+        // Los callbacks pueden cambiar lr (se aplica desde la epoca siguiente)
+        // o pedir que train() se detenga al terminar la epoca actual.
+        template<typename T>
+        struct TrainControl {
+            T lr;
+            bool stop = false;
+        };
+
+        template<typename T>
+        class TrainingCallback {
+        public:
+            virtual ~TrainingCallback() = default;
+            virtual void on_train_begin(bool /*has_validation*/) {}
+            virtual void on_epoch_end(const EpochMetrics<T>& /*m*/, TrainControl<T>& /*ctl*/) {}
+            // La validacion corre en paralelo con el entrenamiento: llega unas
+            // epocas despues de `epoch`, que es la epoca cuyos pesos se evaluaron.
+            virtual void on_validation(size_t /*epoch*/, T /*val_loss*/, TrainControl<T>& /*ctl*/) {}
+            virtual void on_train_end() {}
+        };
+
+        // Escribe las metricas desde un hilo de fondo. on_epoch_end solo copia
+        // a una cola SPSC sin locks; si el escritor se atrasa y la cola se
+        // llena, la linea se descarta (dropped()) en vez de frenar el bucle.
+        template<typename T>
+        class MetricsLogger : public TrainingCallback<T> {
+        public:
+            explicit MetricsLogger(std::ostream& out = std::cout, size_t every = 1)
+              : salida(out), cada(every == 0 ? 1 : every) {}
+
+            MetricsLogger(const MetricsLogger&) = delete;
+            MetricsLogger& operator=(const MetricsLogger&) = delete;
+
+            ~MetricsLogger() override { detener(); }
+
+            void on_train_begin(bool) override {
+                detener();
+                terminar.store(false, std::memory_order_relaxed);
+                escritor = std::thread([this] { bucle_escritor(); });
+            }
+
+            void on_epoch_end(const EpochMetrics<T>& m, TrainControl<T>&) override {
+                if (m.epoch % cada == 0)
+                    encolar({m.epoch, m.train_loss, false});
+            }
+
+            void on_validation(size_t epoch, T val_loss, TrainControl<T>&) override {
+                encolar({epoch, val_loss, true});
+            }
+
+            // Vacia la cola y espera al escritor, asi la salida queda completa
+            // antes de que train() devuelva el control.
+            void on_train_end() override { detener(); }
+
+            size_t dropped() const { return descartadas.load(std::memory_order_relaxed); }
+
+        private:
+            struct Linea {
+                size_t epoch;
+                T valor;
+                bool validacion;
+            };
+
+            void encolar(const Linea& l) {
+                if (!cola.try_push(l))
+                    descartadas.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void detener() {
+                if (!escritor.joinable()) return;
+                terminar.store(true, std::memory_order_release);
+                escritor.join();
+            }
+
+            void bucle_escritor() {
+                Linea l;
+                while (true) {
+                    if (cola.try_pop(l)) {
+                        if (l.validacion)
+                            salida << "Epoch " << l.epoch << ", Val loss: " << l.valor << '\n';
+                        else
+                            salida << "Epoch " << l.epoch << ", Loss: " << l.valor << '\n';
+                        continue;
+                    }
+                    // terminar se publica despues del ultimo push: si tras verlo
+                    // la cola sigue vacia, no queda nada por escribir
+                    if (terminar.load(std::memory_order_acquire) && cola.empty())
+                        break;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                salida.flush();
+            }
+
+            std::ostream& salida;
+            size_t cada;
+            parallel::SpscQueue<Linea, 1024> cola;
+            std::atomic<size_t> descartadas{0};
+            std::atomic<bool> terminar{false};
+            std::thread escritor;
+        };
+
+        // Cuenta evaluaciones seguidas sin mejorar en al menos min_delta y
+        // llama a on_plateau en la `patience`-esima (patience = 0 cuenta
+        // como 1). Mira la perdida de validacion si train() la tiene; si no,
+        // la de entrenamiento.
+        template<typename T>
+        class PlateauMonitor : public TrainingCallback<T> {
+        public:
+            void on_train_begin(bool has_validation) override {
+                usa_validacion = has_validation;
+                mejor = std::numeric_limits<T>::infinity();
+                mejor_epoca = 0;
+                sin_mejora = 0;
+            }
+
+            void on_epoch_end(const EpochMetrics<T>& m, TrainControl<T>& ctl) override {
+                if (!usa_validacion)
+                    observar(m.epoch, m.train_loss, ctl);
+            }
+
+            void on_validation(size_t epoch, T val_loss, TrainControl<T>& ctl) override {
+                if (usa_validacion)
+                    observar(epoch, val_loss, ctl);
+            }
+
+            T best() const { return mejor; }
+            size_t best_epoch() const { return mejor_epoca; }
+
+        protected:
+            PlateauMonitor(size_t patience, T min_delta) : paciencia(patience), delta(min_delta) {}
+
+            // Se llama cuando se agota la paciencia
+            virtual void on_plateau(size_t epoch, TrainControl<T>& ctl) = 0;
+
+            size_t paciencia;
+            T delta;
+            size_t sin_mejora = 0;
+
+        private:
+            void observar(size_t epoch, T loss, TrainControl<T>& ctl) {
+                if (loss < mejor - delta) {
+                    mejor = loss;
+                    mejor_epoca = epoch;
+                    sin_mejora = 0;
+                    return;
+                }
+                if (++sin_mejora >= paciencia)
+                    on_plateau(epoch, ctl);
+            }
+
+            bool usa_validacion = false;
+            T mejor = std::numeric_limits<T>::infinity();
+            size_t mejor_epoca = 0;
+        };
+
+        template<typename T>
+        class EarlyStopping : public PlateauMonitor<T> {
+        public:
+            explicit EarlyStopping(size_t patience, T min_delta = T(0))
+              : PlateauMonitor<T>(patience, min_delta) {}
+
+            void on_train_begin(bool has_validation) override {
+                detenido = false;
+                epoca_detenido = 0;
+                PlateauMonitor<T>::on_train_begin(has_validation);
+            }
+
+            bool stopped() const { return detenido; }
+            size_t stopped_epoch() const { return epoca_detenido; }
+
+        protected:
+            void on_plateau(size_t epoch, TrainControl<T>& ctl) override {
+                ctl.stop = true;
+                detenido = true;
+                epoca_detenido = epoch;
+            }
+
+        private:
+            bool detenido = false;
+            size_t epoca_detenido = 0;
+        };
+
+        // lr *= factor cada vez que se agota la paciencia, sin bajar de min_lr.
+        // Un lr que ya esta en min_lr o por debajo no se toca.
+        template<typename T>
+        class ReduceLROnPlateau : public PlateauMonitor<T> {
+        public:
+            ReduceLROnPlateau(T factor, size_t patience, T min_lr = T(0), T min_delta = T(0))
+              : PlateauMonitor<T>(patience, min_delta), factor_(factor), min_lr_(min_lr) {}
+
+        protected:
+            void on_plateau(size_t, TrainControl<T>& ctl) override {
+                if (ctl.lr > min_lr_)
+                    ctl.lr = std::max(min_lr_, ctl.lr * factor_);
+                this->sin_mejora = 0;
+            }
+
+        private:
+            T factor_, min_lr_;
+        };
+
+        // lr *= gamma cada `step` epocas
+        template<typename T>
+        class StepDecay : public TrainingCallback<T> {
+        public:
+            StepDecay(size_t step, T gamma) : paso(step == 0 ? 1 : step), gamma_(gamma) {}
+
+            void on_epoch_end(const EpochMetrics<T>& m, TrainControl<T>& ctl) override {
+                if ((m.epoch + 1) % paso == 0)
+                    ctl.lr *= gamma_;
+            }
+
+        private:
+            size_t paso;
+            T gamma_;
+        };
+
+    } // namespace nn
+} // namespace utec
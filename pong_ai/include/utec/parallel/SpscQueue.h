@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace utec {
+namespace parallel {
+
+// Cola circular sin locks para un productor y un consumidor. Cada indice lo
+// escribe un solo hilo; el otro lo lee con acquire, asi el elemento copiado
+// en el buffer es visible antes que el indice que lo publica. Los indices
+// van en lineas de cache distintas para que los dos hilos no se invaliden.
+template <typename T, unsigned long Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    // Solo el productor. Devuelve false si la cola esta llena.
+    bool try_push(const T& v) {
+        unsigned long t = cola.load(std::memory_order_relaxed);
+        if (t - cabeza.load(std::memory_order_acquire) == Capacity)
+            return false;
+        buffer[t & (Capacity - 1)] = v;
+        cola.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Solo el consumidor. Devuelve false si la cola esta vacia.
+    bool try_pop(T& v) {
+        unsigned long h = cabeza.load(std::memory_order_relaxed);
+        if (h == cola.load(std::memory_order_acquire))
+            return false;
+        v = buffer[h & (Capacity - 1)];
+        cabeza.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return cabeza.load(std::memory_order_acquire) == cola.load(std::memory_order_acquire);
+    }
+
+    static constexpr unsigned long capacity() { return Capacity; }
+
+private:
+    alignas(64) std::atomic<unsigned long> cabeza{0};
+    alignas(64) std::atomic<unsigned long> cola{0};
+    alignas(64) T buffer[Capacity];
+};
+
+} // namespace parallel
+} // namespace utec
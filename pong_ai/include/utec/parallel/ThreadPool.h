@@ -0,0 +1,301 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#endif
+
+namespace utec {
+namespace parallel {
+
+// Pool de hilos con work-stealing: cada worker tiene su propio deque, toma
+// trabajo de su extremo trasero (LIFO, datos calientes en cache) y roba del
+// delantero de otros workers, primero de los que estan en su mismo nodo NUMA.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // num_threads cuenta tambien al hilo que llama a parallel_for, que
+    // participa ejecutando tareas mientras espera.
+    explicit ThreadPool(unsigned long num_threads = default_threads(), bool pin = true) {
+        std::vector<int> cpus = cpus_por_nodo();
+        unsigned long workers = num_threads > 0 ? num_threads - 1 : 0;
+        for (unsigned long i = 0; i < workers; ++i) {
+            auto w = std::make_unique<Worker>();
+            if (!cpus.empty()) {
+                w->cpu = cpus[(i + 1) % cpus.size()];
+                w->nodo = nodo_de_cpu(w->cpu);
+            }
+            colas.push_back(std::move(w));
+        }
+        for (unsigned long i = 0; i < workers; ++i) {
+            orden_robo.push_back(calcular_orden_robo(i));
+            orden_externo.push_back(i);
+        }
+        for (unsigned long i = 0; i < workers; ++i) {
+            hilos.emplace_back([this, i] { bucle_worker(i); });
+#ifdef __linux__
+            if (pin && colas[i]->cpu >= 0) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(colas[i]->cpu, &set);
+                pthread_setaffinity_np(hilos.back().native_handle(), sizeof(set), &set);
+            }
+#else
+            (void)pin;
+#endif
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_espera);
+            detener = true;
+        }
+        cv_espera.notify_all();
+        for (auto& h : hilos)
+            h.join();
+    }
+
+    unsigned long size() const { return colas.size() + 1; }
+
+    // Ejecuta f(lo, hi) sobre [begin, end) en bloques de al menos `grain`
+    // elementos. Bloquea hasta terminar y relanza la primera excepcion.
+    template <typename Func>
+    void parallel_for(unsigned long begin, unsigned long end, unsigned long grain, Func f) {
+        if (end <= begin) return;
+        unsigned long n = end - begin;
+        if (grain == 0) grain = 1;
+        if (colas.empty() || n <= grain) {
+            f(begin, end);
+            return;
+        }
+        unsigned long bloques = std::min((n + grain - 1) / grain, 4 * size());
+        unsigned long paso = (n + bloques - 1) / bloques;
+        bloques = (n + paso - 1) / paso;
+
+        struct Estado {
+            std::atomic<unsigned long> pendientes;
+            std::exception_ptr error;
+            std::mutex mtx;
+        };
+        auto estado = std::make_shared<Estado>();
+        estado->pendientes = bloques - 1;
+
+        long propio = worker_actual();
+        for (unsigned long b = 1; b < bloques; ++b) {
+            unsigned long lo = begin + b * paso;
+            unsigned long hi = std::min(end, lo + paso);
+            Task t = [estado, &f, lo, hi] {
+                try {
+                    f(lo, hi);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(estado->mtx);
+                    if (!estado->error) estado->error = std::current_exception();
+                }
+                estado->pendientes.fetch_sub(1, std::memory_order_acq_rel);
+            };
+            unsigned long destino = propio >= 0
+                ? static_cast<unsigned long>(propio)
+                : siguiente.fetch_add(1, std::memory_order_relaxed) % colas.size();
+            en_cola.fetch_add(1, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(colas[destino]->mtx);
+            colas[destino]->tareas.push_back(std::move(t));
+        }
+        {
+            // Sincroniza con el predicado de espera para no perder el aviso
+            std::lock_guard<std::mutex> lock(mtx_espera);
+        }
+        cv_espera.notify_all();
+
+        try {
+            f(begin, std::min(end, begin + paso));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(estado->mtx);
+            if (!estado->error) estado->error = std::current_exception();
+        }
+        // El hilo que llama ayuda en vez de bloquearse: evita deadlocks en
+        // parallel_for anidados.
+        while (estado->pendientes.load(std::memory_order_acquire) > 0) {
+            Task t;
+            if (obtener_tarea(propio, t))
+                t();
+            else
+                std::this_thread::yield();
+        }
+        if (estado->error)
+            std::rethrow_exception(estado->error);
+    }
+
+    static ThreadPool& global() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    static unsigned long default_threads() {
+        if (const char* env = std::getenv("UTEC_NUM_THREADS")) {
+            long n = std::atol(env);
+            if (n > 0) return static_cast<unsigned long>(n);
+        }
+        unsigned long n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+private:
+    struct Worker {
+        std::deque<Task> tareas;
+        std::mutex mtx;
+        int cpu = -1;
+        int nodo = 0;
+    };
+
+    static long& indice_tls() {
+        thread_local long idx = -1;
+        return idx;
+    }
+
+    long worker_actual() const {
+        return pool_tls() == this ? indice_tls() : -1;
+    }
+
+    static const ThreadPool*& pool_tls() {
+        thread_local const ThreadPool* p = nullptr;
+        return p;
+    }
+
+    void bucle_worker(unsigned long i) {
+        pool_tls() = this;
+        indice_tls() = static_cast<long>(i);
+        while (true) {
+            Task t;
+            if (obtener_tarea(static_cast<long>(i), t)) {
+                t();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(mtx_espera);
+            cv_espera.wait(lock, [this] {
+                return detener || en_cola.load(std::memory_order_acquire) > 0;
+            });
+            if (detener && en_cola.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+
+    bool obtener_tarea(long propio, Task& t) {
+        if (propio >= 0) {
+            Worker& w = *colas[propio];
+            std::lock_guard<std::mutex> lock(w.mtx);
+            if (!w.tareas.empty()) {
+                t = std::move(w.tareas.back());
+                w.tareas.pop_back();
+                en_cola.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        const std::vector<unsigned long>& orden = propio >= 0 ? orden_robo[propio] : orden_externo;
+        for (unsigned long v : orden) {
+            Worker& w = *colas[v];
+            std::lock_guard<std::mutex> lock(w.mtx);
+            if (!w.tareas.empty()) {
+                t = std::move(w.tareas.front());
+                w.tareas.pop_front();
+                en_cola.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Victimas del mismo nodo NUMA primero, luego el resto.
+    std::vector<unsigned long> calcular_orden_robo(unsigned long i) const {
+        std::vector<unsigned long> orden;
+        for (unsigned long k = 1; k < colas.size(); ++k)
+            orden.push_back((i + k) % colas.size());
+        std::stable_partition(orden.begin(), orden.end(), [&](unsigned long v) {
+            return colas[v]->nodo == colas[i]->nodo;
+        });
+        return orden;
+    }
+
+    static std::vector<int> parse_cpulist(const std::string& s) {
+        std::vector<int> cpus;
+        std::stringstream ss(s);
+        std::string rango;
+        while (std::getline(ss, rango, ',')) {
+            if (rango.empty() || rango == "\n") continue;
+            auto guion = rango.find('-');
+            int lo = std::atoi(rango.substr(0, guion).c_str());
+            int hi = guion == std::string::npos ? lo : std::atoi(rango.substr(guion + 1).c_str());
+            for (int c = lo; c <= hi; ++c)
+                cpus.push_back(c);
+        }
+        return cpus;
+    }
+
+    static int nodo_de_cpu(int cpu) {
+        for (int nodo = 0; nodo < 64; ++nodo) {
+            std::ifstream f("/sys/devices/system/node/node" + std::to_string(nodo) + "/cpulist");
+            if (!f) break;
+            std::string lista;
+            std::getline(f, lista);
+            for (int c : parse_cpulist(lista))
+                if (c == cpu) return nodo;
+        }
+        return 0;
+    }
+
+    // CPUs permitidas al proceso, agrupadas por nodo NUMA para que workers
+    // consecutivos compartan cache de ultimo nivel.
+    static std::vector<int> cpus_por_nodo() {
+        std::vector<int> cpus;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int c = 0; c < CPU_SETSIZE; ++c)
+                if (CPU_ISSET(c, &set)) cpus.push_back(c);
+        }
+        std::vector<std::pair<int, int>> por_nodo;
+        for (int c : cpus)
+            por_nodo.push_back({nodo_de_cpu(c), c});
+        std::stable_sort(por_nodo.begin(), por_nodo.end());
+        for (unsigned long i = 0; i < cpus.size(); ++i)
+            cpus[i] = por_nodo[i].second;
+#endif
+        return cpus;
+    }
+
+    std::vector<std::unique_ptr<Worker>> colas;
+    std::vector<std::vector<unsigned long>> orden_robo;
+    std::vector<unsigned long> orden_externo;
+    std::vector<std::thread> hilos;
+    std::atomic<unsigned long> en_cola{0};
+    std::atomic<unsigned long> siguiente{0};
+    std::mutex mtx_espera;
+    std::condition_variable cv_espera;
+    bool detener = false;
+};
+
+template <typename Func>
+void parallel_for(unsigned long begin, unsigned long end, unsigned long grain, Func f) {
+    ThreadPool::global().parallel_for(begin, end, grain, f);
+}
+
+} // namespace parallel
+} // namespace utec
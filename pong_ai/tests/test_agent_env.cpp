@@ -1,8 +1,13 @@
 #include <cassert>
+#include <cstdio>
+#include <fstream>
 #include "PongAgent.h"
 #include "EnvGym.h"
 #include "dense.h"
 #include "activation.h"
+#include "conv.h"
+#include "TrajectoryRecorder.h"
+#include "CompiledPolicy.h"
 
 using namespace utec::agent;
 using namespace utec::nn;
@@ -24,6 +29,17 @@ public:
     }
 };
 
+class RenderEnv : public MockEnv {
+public:
+    mutable int frames = 0;
+
+    void render(const State& s, float* frame, size_t height, size_t width) const override {
+        ++frames;
+        EnvGym::render(s, frame, height, width);
+        std::fill(frame, frame + width, 0.5f);
+    }
+};
+
 void test_agent_decision() {
     NeuralNetwork<float> model;
     model.add_layer(std::make_unique<Dense<float>>(3, 4));
@@ -34,10 +50,107 @@ void test_agent_decision() {
     State s{0.5f, 0.3f, 0.2f};
     int action = agent.act(s);
     assert(action >= -1 && action <= 1);
+    assert(agent.sample(s, 10, 0.0f) == action);
+    assert(agent.sample(s, 10, 1.0f) == agent.sample(s, 10, 1.0f));
+    CompiledNetwork<float> compiled(model);
+    PongAgent<float> jit(compiled_policy(compiled, 3));
+    assert(jit.act(s) == action);
     std::cout << "test_agent_decision passed\n";
 }
 
+void test_trajectory_roundtrip() {
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Dense<float>>(3, 4));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<Dense<float>>(4, 1));
+    PongAgent<float> agent(model);
+    MockEnv env;
+
+    const std::string path = "test_trajectory.ptrj";
+    const int pasos = 10000;
+    std::vector<State> estados;
+    std::vector<int> acciones;
+    {
+        TrajectoryRecorder rec(path, 1024);
+        State s = env.reset();
+        for (int t = 0; t < pasos; ++t) {
+            int a = (t % 7 == 0) ? -1 : agent.act(s);
+            float reward;
+            bool done;
+            estados.push_back(s);
+            acciones.push_back(a);
+            State next = env.step(a, reward, done);
+            rec.record(s, a, reward, t + 1 == pasos);
+            s = next;
+        }
+    }
+
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    assert(static_cast<size_t>(f.tellg()) < pasos * (4 * sizeof(float) + 2));
+
+    TrajectoryReader reader(path);
+    utec::algebra::Tensor<float, 2> S, A, R, D;
+    size_t fila = 0, bloques = 0;
+    while (reader.next_chunk(S, A, R, D)) {
+        for (size_t i = 0; i < S.shape()[0]; ++i, ++fila) {
+            assert(S(i, 0) == estados[fila].ball_x);
+            assert(S(i, 2) == estados[fila].paddle_y);
+            assert(A(i, 0) == float(acciones[fila]));
+            assert(R(i, 0) == (acciones[fila] != 0 ? 1.0f : 0.0f));
+            assert(D(i, 0) == (fila + 1 == pasos ? 1.0f : 0.0f));
+        }
+        ++bloques;
+    }
+    assert(fila == pasos && bloques == 10);
+
+    // Una cabecera de bloque a medias no es un fin de archivo limpio
+    {
+        std::ofstream cola(path, std::ios::binary | std::ios::app);
+        cola.write("\x01\x00", 2);
+    }
+    TrajectoryReader cortado(path);
+    size_t leidos = 0;
+    bool error = false;
+    try {
+        while (cortado.next_chunk(S, A, R, D))
+            ++leidos;
+    } catch (const TrajectoryError&) {
+        error = true;
+    }
+    assert(error && leidos == 10);
+    std::remove(path.c_str());
+    std::cout << "test_trajectory_roundtrip passed\n";
+}
+
+void test_agent_pixels() {
+    NeuralNetwork<float> model;
+    model.add_layer(std::make_unique<Conv2D<float>>(1, 16, 16, 4, 3, 1, 1));
+    model.add_layer(std::make_unique<ReLU<float>>());
+    model.add_layer(std::make_unique<MaxPool2D<float>>(4, 16, 16, 2));
+    model.add_layer(std::make_unique<Flatten<float>>(4, 8, 8));
+    model.add_layer(std::make_unique<Dense<float>>(4 * 8 * 8, 1));
+
+    MockEnv env;
+    std::vector<float> frame(16 * 16);
+    env.render(env.reset(), frame.data(), 16, 16);
+    assert(frame[4 * 16 + 8] == 1.0f);   // pelota en (0.5, 0.3)
+    assert(frame[3 * 16 + 0] == 1.0f);   // paleta en y = 0.2
+
+    PongAgent<float> agent(model, ObservationMode::Pixels, 16, 16);
+    int action = agent.act(env.reset());
+    assert(action >= -1 && action <= 1);
+
+    // Con el entorno como renderer el agente usa su render() sobreescrito
+    RenderEnv propio;
+    PongAgent<float> con_env(model, propio, 16, 16);
+    con_env.act(propio.reset());
+    assert(propio.frames == 1);
+    std::cout << "test_agent_pixels passed\n";
+}
+
 int main() {
     test_agent_decision();
+    test_trajectory_roundtrip();
+    test_agent_pixels();
     return 0;
 }
\ No newline at end of file
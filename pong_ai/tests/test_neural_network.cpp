@@ -1,8 +1,15 @@
 #include <cassert>
+#include <cmath>
+#include <sstream>
 #include "neural_network.h"
 #include "dense.h"
 #include "activation.h"
 #include "loss.h"
+#include "conv.h"
+#include "autograd.h"
+#include "dropout.h"
+#include "codegen.h"
+#include "training.h"
 
 using namespace utec::nn;
 
@@ -29,4 +36,512 @@ void test_neural_network_xor() {
     }
     assert(correct == 4);
     std::cout << "test_neural_network_xor passed\n";
+}
+
+void test_checkpointing_matches_full() {
+    Tensor2<float> X(32, 8);
+    Tensor2<float> Y(32, 1);
+    for (size_t i = 0; i < 32; ++i) {
+        for (size_t j = 0; j < 8; ++j)
+            X(i, j) = float((i * 7 + j * 3) % 11) / 11.0f;
+        Y(i, 0) = float(i % 2);
+    }
+
+    auto build = [](NeuralNetwork<float>& net) {
+        net.add_layer(std::make_unique<Dense<float>>(8, 16));
+        for (int k = 0; k < 6; ++k) {
+            net.add_layer(std::make_unique<ReLU<float>>());
+            net.add_layer(std::make_unique<Dense<float>>(16, 16));
+        }
+        net.add_layer(std::make_unique<ReLU<float>>());
+        net.add_layer(std::make_unique<Dense<float>>(16, 1));
+    };
+
+    NeuralNetwork<float> full, ckpt;
+    build(full);
+    build(ckpt);
+    ckpt.enable_checkpointing(4);
+
+    for (int e = 0; e < 20; ++e) {
+        full.backward(full.forward(X), Y);
+        full.optimize(0.01f);
+        ckpt.backward(ckpt.forward(X), Y);
+        ckpt.optimize(0.01f);
+    }
+
+    auto a = full.forward(X);
+    auto b = ckpt.forward(X);
+    for (size_t i = 0; i < 32; ++i)
+        assert(a(i, 0) == b(i, 0));
+    assert(ckpt.peak_activation_bytes() < full.peak_activation_bytes());
+
+    // Cambiar el modo entre forward y backward: backward sigue al ultimo forward
+    auto pa = full.forward(X);
+    full.enable_checkpointing(1);
+    full.backward(pa, Y);
+    full.optimize(0.01f);
+    auto pb = ckpt.forward(X);
+    ckpt.enable_checkpointing(0);
+    ckpt.backward(pb, Y);
+    ckpt.optimize(0.01f);
+    a = full.forward(X);
+    b = ckpt.forward(X);
+    for (size_t i = 0; i < 32; ++i)
+        assert(a(i, 0) == b(i, 0));
+    full.backward(a, Y);
+    bool lanzo = false;
+    try {
+        full.backward(a, Y);
+    } catch (const utec::algebra::TensorError&) {
+        lanzo = true;
+    }
+    assert(lanzo);
+    std::cout << "test_checkpointing_matches_full passed\n";
+}
+
+
+void test_sparse_dense_matches_pruned_dense() {
+    Dense<float> dense(16, 8);
+    Tensor2<float> X(5, 16);
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t k = 0; k < 16; ++k)
+            X(i, k) = float((i * 5 + k) % 9) / 9.0f - 0.5f;
+
+    SparseDense<float> mag(dense, PruneMode::Magnitude, 0.75f);
+    assert(mag.nnz() == 32);
+
+    SparseDense<float> s24(dense, PruneMode::Structured2of4);
+    auto W24 = s24.to_dense();
+    for (size_t j = 0; j < 8; ++j) {
+        for (size_t k0 = 0; k0 < 16; k0 += 4) {
+            int vivos = 0;
+            for (size_t k = k0; k < k0 + 4; ++k)
+                vivos += W24(k, j) != 0.0f;
+            assert(vivos == 2);
+        }
+    }
+
+    auto W = mag.to_dense();
+    auto Y = mag.forward(X);
+    auto Y_ref = utec::algebra::matrix_product(X, W);
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t j = 0; j < 8; ++j)
+            assert(std::abs(Y(i, j) - Y_ref(i, j)) < 1e-5f);
+
+    Tensor2<float> G(5, 8);
+    G.fill(1.0f);
+    auto dX = mag.backward(G);
+    auto dX_ref = utec::algebra::matrix_product(G, W.transpose_2d());
+    for (size_t i = 0; i < 5; ++i)
+        for (size_t k = 0; k < 16; ++k)
+            assert(std::abs(dX(i, k) - dX_ref(i, k)) < 1e-5f);
+    std::cout << "test_sparse_dense_matches_pruned_dense passed\n";
+}
+
+
+// Convolucion directa de referencia
+static Tensor4<float> conv_directa(const Tensor4<float>& x, const Tensor2<float>& W, const Tensor2<float>& b,
+                                   size_t OC, size_t K, size_t S, size_t P, size_t OH, size_t OW) {
+    size_t N = x.shape()[0], C = x.shape()[1], H = x.shape()[2], Wd = x.shape()[3];
+    Tensor4<float> y(N, OC, OH, OW);
+    for (size_t n = 0; n < N; ++n)
+        for (size_t o = 0; o < OC; ++o)
+            for (size_t oy = 0; oy < OH; ++oy)
+                for (size_t ox = 0; ox < OW; ++ox) {
+                    float acc = b(o, 0);
+                    for (size_t c = 0; c < C; ++c)
+                        for (size_t ky = 0; ky < K; ++ky)
+                            for (size_t kx = 0; kx < K; ++kx) {
+                                long iy = long(oy * S + ky) - long(P), ix = long(ox * S + kx) - long(P);
+                                if (iy >= 0 && iy < long(H) && ix >= 0 && ix < long(Wd))
+                                    acc += x(n, c, iy, ix) * W(o, (c * K + ky) * K + kx);
+                            }
+                    y(n, o, oy, ox) = acc;
+                }
+    return y;
+}
+
+void test_conv2d_im2col_winograd() {
+    Tensor4<float> x(2, 3, 7, 9);
+    size_t i = 0;
+    for (auto& v : x) v = float((i++ * 37) % 17) / 17.0f - 0.5f;
+
+    Conv2D<float> strided(3, 7, 9, 4, 3, 2, 1, ConvAlgo::Im2col);
+    Conv2D<float> im2col(3, 7, 9, 4, 3, 1, 1, ConvAlgo::Im2col);
+    Conv2D<float> winograd(3, 7, 9, 4, 3, 1, 1, ConvAlgo::Winograd);
+
+    auto ref_s = conv_directa(x, strided.weights(), strided.bias(), 4, 3, 2, 1, strided.out_h(), strided.out_w());
+    auto y_s = strided.forward(x);
+    auto ref = conv_directa(x, im2col.weights(), im2col.bias(), 4, 3, 1, 1, 7, 9);
+    auto y_i = im2col.forward(x);
+    auto y_w = winograd.forward(x);
+    for (size_t k = 0; k < ref_s.tamano_total(); ++k)
+        assert(std::abs(y_s.begin()[k] - ref_s.begin()[k]) < 1e-5f);
+    for (size_t k = 0; k < ref.tamano_total(); ++k) {
+        assert(std::abs(y_i.begin()[k] - ref.begin()[k]) < 1e-5f);
+        assert(std::abs(y_w.begin()[k] - ref.begin()[k]) < 1e-5f);
+    }
+
+    // dX por diferencias finitas con perdida sum(y * G)
+    Tensor4<float> G(2, 4, 4, 5);
+    i = 0;
+    for (auto& v : G) v = float((i++ * 11) % 7) / 7.0f;
+    auto dx = strided.backward(G);
+    const float eps = 1e-2f;
+    for (size_t k : {0ul, 17ul, 101ul, 250ul}) {
+        Tensor4<float> xp = x, xm = x;
+        xp.begin()[k] += eps;
+        xm.begin()[k] -= eps;
+        auto yp = strided.forward(xp) * G;
+        auto ym = strided.forward(xm) * G;
+        float num = (std::accumulate(yp.begin(), yp.end(), 0.0f) -
+                     std::accumulate(ym.begin(), ym.end(), 0.0f)) / (2 * eps);
+        assert(std::abs(num - dx.begin()[k]) < 1e-2f);
+    }
+
+    // dW y db contra la suma directa; tras optimize() Winograd debe usar los
+    // pesos nuevos y no filtros transformados de antes
+    Tensor4<float> Gw(2, 4, 7, 9);
+    i = 0;
+    for (auto& v : Gw) v = float((i++ * 5) % 11) / 11.0f - 0.5f;
+    winograd.backward(Gw);
+    const auto& dW = winograd.grad_weights();
+    const auto& db = winograd.grad_bias();
+    for (size_t o = 0; o < 4; ++o) {
+        float sb = 0;
+        for (size_t n = 0; n < 2; ++n)
+            for (size_t y = 0; y < 7; ++y)
+                for (size_t xx = 0; xx < 9; ++xx)
+                    sb += Gw(n, o, y, xx);
+        assert(std::abs(db(o, 0) - sb) < 1e-4f);
+        for (size_t c = 0; c < 3; ++c)
+            for (size_t ky = 0; ky < 3; ++ky)
+                for (size_t kx = 0; kx < 3; ++kx) {
+                    float s = 0;
+                    for (size_t n = 0; n < 2; ++n)
+                        for (size_t y = 0; y < 7; ++y)
+                            for (size_t xx = 0; xx < 9; ++xx) {
+                                long iy = long(y + ky) - 1, ix = long(xx + kx) - 1;
+                                if (iy >= 0 && iy < 7 && ix >= 0 && ix < 9)
+                                    s += Gw(n, o, y, xx) * x(n, c, iy, ix);
+                            }
+                    assert(std::abs(dW(o, (c * 3 + ky) * 3 + kx) - s) < 1e-4f);
+                }
+    }
+    winograd.optimize(0.1f);
+    auto ref2 = conv_directa(x, winograd.weights(), winograd.bias(), 4, 3, 1, 1, 7, 9);
+    auto y_w2 = winograd.forward(x);
+    for (size_t k = 0; k < ref2.tamano_total(); ++k)
+        assert(std::abs(y_w2.begin()[k] - ref2.begin()[k]) < 1e-4f);
+
+    MaxPool2D<float> pool(4, 7, 9, 2);
+    auto p = pool.forward(y_w);
+    assert(p.shape()[2] == 3 && p.shape()[3] == 4);
+    assert(p(1, 2, 1, 3) == std::max({y_w(1, 2, 2, 6), y_w(1, 2, 2, 7), y_w(1, 2, 3, 6), y_w(1, 2, 3, 7)}));
+    std::cout << "test_conv2d_im2col_winograd passed\n";
+}
+
+
+void test_autograd_matches_handwritten() {
+    Tensor2<float> X(6, 4);
+    for (size_t i = 0; i < 6; ++i)
+        for (size_t k = 0; k < 4; ++k)
+            X(i, k) = float((i * 3 + k * 5) % 7) / 7.0f - 0.4f;
+    Tensor2<float> G(6, 3);
+    G.fill(0.5f);
+    G(2, 1) = -1.0f;
+
+    Dense<float> dense(4, 3);
+    ReLU<float> relu;
+    auto y_ref = relu.forward(dense.forward(X));
+    auto dx_ref = dense.backward(relu.backward(G));
+
+    using Var = Tape<float>::Var;
+    AutogradLayer<float> layer({dense.weights(), dense.bias()},
+        [](Tape<float>& t, Var x, const std::vector<Var>& p) {
+            return t.relu(t.add(t.matmul(x, p[0]), p[1]));
+        });
+    auto y = layer.forward(X);
+    auto dx = layer.backward(G);
+    for (size_t i = 0; i < 6; ++i) {
+        for (size_t j = 0; j < 3; ++j)
+            assert(std::abs(y(i, j) - y_ref(i, j)) < 1e-6f);
+        for (size_t k = 0; k < 4; ++k)
+            assert(std::abs(dx(i, k) - dx_ref(i, k)) < 1e-5f);
+    }
+    assert(layer.grads()[1].shape()[0] == 1 && layer.grads()[1].shape()[1] == 3);
+
+    // Cadena unaria fusionada frente a diferencias finitas
+    Tape<float> tape;
+    auto x = tape.input(X, true);
+    auto target = tape.input(Tensor2<float>(6, 4));
+    auto loss = tape.mse(tape.sigmoid(tape.tanh(tape.scale(x, 2.0f))), target);
+    tape.backward(loss);
+    auto dX = tape.grad(x);
+    auto f = [&](const Tensor2<float>& in) {
+        Tape<float> t;
+        auto v = t.mse(t.sigmoid(t.tanh(t.scale(t.input(in), 2.0f))), t.input(Tensor2<float>(6, 4)));
+        return t.value(v)(0, 0);
+    };
+    const float eps = 1e-3f;
+    for (size_t k : {0ul, 5ul, 13ul, 23ul}) {
+        Tensor2<float> xp = X, xm = X;
+        xp.begin()[k] += eps;
+        xm.begin()[k] -= eps;
+        float num = (f(xp) - f(xm)) / (2 * eps);
+        assert(std::abs(num - dX.begin()[k]) < 1e-3f);
+    }
+
+    // Un nodo unario con dos consumidores (sum y sigmoid) no se fusiona.
+    // sum(u) va antes en la cinta: el backward de sigmoid llega primero a u.
+    auto g = [](Tape<float>& t, Var in) {
+        auto u = t.tanh(in);
+        auto a = t.sum(u, 1);
+        auto b = t.sum(t.sigmoid(u), 1);
+        return t.sum(t.add(a, b), 0);
+    };
+    Tape<float> tape2;
+    auto x2 = tape2.input(X, true);
+    tape2.backward(g(tape2, x2));
+    auto dX2 = tape2.grad(x2);
+    auto f2 = [&](const Tensor2<float>& in) {
+        Tape<float> t;
+        return t.value(g(t, t.input(in)))(0, 0);
+    };
+    for (size_t k : {0ul, 7ul, 13ul, 22ul}) {
+        Tensor2<float> xp = X, xm = X;
+        xp.begin()[k] += eps;
+        xm.begin()[k] -= eps;
+        float num = (f2(xp) - f2(xm)) / (2 * eps);
+        assert(std::abs(num - dX2.begin()[k]) < 1e-2f);
+    }
+    std::cout << "test_autograd_matches_handwritten passed\n";
+}
+
+
+void test_layer_init_streams_and_dropout() {
+    Dense<float> a(8, 8, 42, 0), b(8, 8, 42, 0), c(8, 8, 42, 1);
+    assert(a.weights()(3, 5) == b.weights()(3, 5));
+    assert(a.weights()(3, 5) != c.weights()(3, 5));
+    // Fuera de una red, sin id explicito, W se llena en el primer uso con el stream 0
+    Dense<float> suelta(8, 8);
+    assert(suelta.weights()(3, 5) == a.weights()(3, 5));
+
+    // En la red cada capa con parametros recibe su propio id
+    NeuralNetwork<float> net;
+    auto d0 = std::make_unique<Dense<float>>(8, 8);
+    auto d1 = std::make_unique<Dense<float>>(8, 8);
+    auto* p0 = d0.get();
+    auto* p1 = d1.get();
+    net.add_layer(std::move(d0));
+    net.add_layer(std::make_unique<ReLU<float>>());
+    net.add_layer(std::move(d1));
+    assert(p0->weights()(0, 0) == a.weights()(0, 0));
+    assert(p1->weights()(0, 0) == c.weights()(0, 0));
+
+    Dropout<float> drop(0.5f, 42, 0);
+    Tensor2<float> X(64, 64);
+    X.fill(1.0f);
+    auto y1 = drop.forward(X);
+    auto y1b = drop.forward(X);
+    size_t ceros = 0;
+    for (size_t k = 0; k < y1.tamano_total(); ++k) {
+        assert(y1.begin()[k] == y1b.begin()[k]);
+        assert(y1.begin()[k] == 0.0f || y1.begin()[k] == 2.0f);
+        ceros += y1.begin()[k] == 0.0f;
+    }
+    assert(ceros > 1800 && ceros < 2300);
+    auto g = drop.backward(X);
+    assert(g(1, 2) == y1(1, 2));
+    auto y2 = drop.forward(X);
+    bool distinta = false;
+    for (size_t k = 0; k < y2.tamano_total(); ++k)
+        distinta |= y2.begin()[k] != y1.begin()[k];
+    assert(distinta);
+    drop.set_training(false);
+    assert(drop.forward(X)(0, 0) == 1.0f);
+
+    // Dos Dropout seguidos en una red no repiten mascara, ni la repite uno suelto
+    NeuralNetwork<float> con_dropout;
+    auto q0 = std::make_unique<Dropout<float>>(0.5f);
+    auto q1 = std::make_unique<Dropout<float>>(0.5f);
+    auto* r0 = q0.get();
+    auto* r1 = q1.get();
+    con_dropout.add_layer(std::make_unique<Dense<float>>(64, 64));
+    con_dropout.add_layer(std::move(q0));
+    con_dropout.add_layer(std::move(q1));
+    con_dropout.add_layer(std::make_unique<Dense<float>>(64, 1));
+    Dropout<float> suelto(0.5f);
+    auto m0 = r0->forward(X), m1 = r1->forward(X), ms = suelto.forward(X);
+    bool distinta01 = false, distinta_suelto = false;
+    for (size_t k = 0; k < m0.tamano_total(); ++k) {
+        distinta01 |= m0.begin()[k] != m1.begin()[k];
+        distinta_suelto |= m0.begin()[k] != ms.begin()[k];
+    }
+    assert(distinta01 && distinta_suelto);
+    std::cout << "test_layer_init_streams_and_dropout passed\n";
+}
+
+void test_compiled_network_matches_forward() {
+    NeuralNetwork<float> net;
+    net.add_layer(std::make_unique<Dense<float>>(6, 32));
+    net.add_layer(std::make_unique<ReLU<float>>());
+    net.add_layer(std::make_unique<Dense<float>>(32, 16));
+    net.add_layer(std::make_unique<ReLU<float>>());
+    net.add_layer(std::make_unique<Dense<float>>(16, 2));
+    net.sparsify(PruneMode::Magnitude, 0.5f);
+
+    Tensor2<float> X(9, 6);
+    for (size_t i = 0; i < 9; ++i)
+        for (size_t k = 0; k < 6; ++k)
+            X(i, k) = float((i * 7 + k * 3) % 11) / 11.0f - 0.4f;
+    auto esperado = net.forward(X);
+
+    // Bucles de tamano fijo (por defecto) y desenrollado completo
+    for (size_t limite : {size_t(0), size_t(4096)}) {
+        JitOptions opts;
+        opts.unroll_limit = limite;
+        CompiledNetwork<float> jit(net, opts);
+        assert(jit.in_features() == 6 && jit.out_features() == 2);
+        auto y = jit.forward(X);
+        for (size_t i = 0; i < 9; ++i)
+            for (size_t j = 0; j < 2; ++j)
+                assert(std::abs(y(i, j) - esperado(i, j)) < 1e-5f);
+    }
+
+    NeuralNetwork<float> conv;
+    conv.add_layer(std::make_unique<Conv2D<float>>(1, 4, 4, 2, 3));
+    bool lanzo = false;
+    try {
+        CompiledNetwork<float> jit(conv);
+    } catch (const CodegenError&) {
+        lanzo = true;
+    }
+    assert(lanzo);
+    std::cout << "test_compiled_network_matches_forward passed\n";
+}
+
+// Registra lo que train() reporta a los callbacks
+class Registro : public TrainingCallback<float> {
+public:
+    std::vector<EpochMetrics<float>> epocas;
+    std::vector<std::pair<size_t, float>> validaciones;
+
+    void on_epoch_end(const EpochMetrics<float>& m, TrainControl<float>&) override {
+        epocas.push_back(m);
+    }
+
+    void on_validation(size_t epoch, float val_loss, TrainControl<float>&) override {
+        validaciones.push_back({epoch, val_loss});
+    }
+};
+
+void test_training_callbacks() {
+    Tensor2<float> X(16, 3), Y(16, 1);
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t k = 0; k < 3; ++k)
+            X(i, k) = float((i * 5 + k * 3) % 7) / 7.0f;
+        Y(i, 0) = X(i, 0) - 0.5f * X(i, 2);
+    }
+    auto Xv = X, Yv = Y;
+
+    NeuralNetwork<float> net;
+    net.add_layer(std::make_unique<Dense<float>>(3, 8));
+    net.add_layer(std::make_unique<ReLU<float>>());
+    net.add_layer(std::make_unique<Dropout<float>>(0.2f));
+    net.add_layer(std::make_unique<Dense<float>>(8, 1));
+
+    // Tras la primera epoca lr = 0: la perdida se estanca y EarlyStopping corta
+    Registro reg;
+    StepDecay<float> decay(1, 0.0f);
+    EarlyStopping<float> stop(3);
+    std::ostringstream log;
+    MetricsLogger<float> logger(log, 1);
+    size_t epocas = net.train(X, Y, 100000, 0.05f, {&reg, &decay, &stop, &logger}, &Xv, &Yv);
+
+    assert(stop.stopped());
+    assert(epocas < 100000 && epocas == reg.epocas.size());
+    assert(reg.epocas[0].lr == 0.05f && reg.epocas[1].lr == 0.0f);
+    // Desde la epoca 1 los pesos no cambian: la validacion en modo inferencia
+    // ve siempre la misma perdida, y coincide con evaluate() sin Dropout
+    assert(reg.validaciones.size() >= 4);
+    net.set_training(false);
+    float esperado = net.evaluate(Xv, Yv);
+    for (size_t k = 1; k < reg.validaciones.size(); ++k) {
+        assert(reg.validaciones[k].first > reg.validaciones[k - 1].first);
+        if (reg.validaciones[k].first >= 1)
+            assert(std::abs(reg.validaciones[k].second - esperado) < 1e-6f);
+    }
+    assert(stop.best_epoch() <= 1);
+    assert(logger.dropped() == 0);
+    assert(log.str().find("Epoch 0, Loss: ") == 0);
+    assert(log.str().find("Val loss: ") != std::string::npos);
+
+    // La perdida reportada es la que calculo backward; con lr = 0 no cambia,
+    // y ReduceLROnPlateau no sube un lr que ya esta bajo min_lr
+    NeuralNetwork<float> lineal;
+    lineal.add_layer(std::make_unique<Dense<float>>(3, 1));
+    float inicial = lineal.evaluate(X, Y);
+    Registro r2;
+    ReduceLROnPlateau<float> plateau(0.5f, 0, 1e-3f);
+    lineal.train(X, Y, 3, 0.0f, {&r2, &plateau});
+    assert(r2.epocas.size() == 3);
+    for (auto& m : r2.epocas) {
+        assert(m.train_loss == inicial);
+        assert(m.lr == 0.0f);
+    }
+    // Por encima de min_lr si reduce, y se detiene en min_lr
+    ReduceLROnPlateau<float> reduce(0.5f, 0, 0.04f);
+    TrainControl<float> ctl{0.1f};
+    reduce.on_train_begin(true);
+    reduce.on_validation(0, 1.0f, ctl);
+    reduce.on_validation(1, 1.0f, ctl);
+    assert(ctl.lr == 0.05f);
+    reduce.on_validation(2, 1.0f, ctl);
+    assert(ctl.lr == 0.04f);
+
+    // EarlyStopping(2) corta en la segunda evaluacion seguida sin mejora
+    EarlyStopping<float> corta(2);
+    TrainControl<float> c2{0.1f};
+    corta.on_train_begin(false);
+    EpochMetrics<float> m{0, 1.0f, 0.1f};
+    corta.on_epoch_end(m, c2);
+    m.epoch = 1;
+    corta.on_epoch_end(m, c2);
+    assert(!c2.stop);
+    m.epoch = 2;
+    corta.on_epoch_end(m, c2);
+    assert(c2.stop && corta.stopped_epoch() == 2);
+
+    // clone() copia solo parametros: ninguna capa de la copia trae caches
+    NeuralNetwork<float> cnn;
+    cnn.add_layer(std::make_unique<Conv2D<float>>(1, 4, 4, 2, 3, 1, 1, ConvAlgo::Winograd));
+    cnn.add_layer(std::make_unique<MaxPool2D<float>>(2, 4, 4, 2));
+    cnn.add_layer(std::make_unique<Flatten<float>>(2, 2, 2));
+    cnn.add_layer(std::make_unique<Dense<float>>(8, 4));
+    cnn.add_layer(std::make_unique<ReLU<float>>());
+    cnn.add_layer(std::make_unique<Dropout<float>>(0.5f));
+    cnn.add_layer(std::make_unique<Dense<float>>(4, 1));
+    cnn.sparsify(PruneMode::Magnitude, 0.25f);
+    Tensor2<float> img(3, 16);
+    for (size_t k = 0; k < img.tamano_total(); ++k) img.begin()[k] = float(k % 5) / 5.0f;
+    cnn.forward(img);
+    auto copia = cnn.clone();
+    assert(copia);
+    size_t con_cache = 0;
+    for (size_t k = 0; k < copia->num_layers(); ++k) {
+        con_cache += cnn.layer(k).cache_bytes() > 0;
+        assert(copia->layer(k).cache_bytes() == 0);
+    }
+    assert(con_cache == cnn.num_layers() - 1);  // todas menos Flatten
+    cnn.set_training(false);
+    copia->set_training(false);
+    auto y_orig = cnn.forward(img), y_copia = copia->forward(img);
+    for (size_t k = 0; k < y_orig.tamano_total(); ++k)
+        assert(y_orig.begin()[k] == y_copia.begin()[k]);
+
+    // Reusar EarlyStopping en otro train() empieza sin la parada anterior
+    lineal.train(X, Y, 2, 0.01f, {&stop});
+    assert(!stop.stopped());
+    std::cout << "test_training_callbacks passed\n";
 }
\ No newline at end of file
@@ -1,5 +1,10 @@
 #include <cassert>
+#include <atomic>
+#include <cmath>
+#include <vector>
 #include "Tensor.h"
+#include "ThreadPool.h"
+#include "Random.h"
 
 using namespace utec::algebra;
 
@@ -10,4 +15,124 @@ void test_tensor_basic() {
     t.reshape(3, 2);
     assert(t.shape()[0] == 3 && t.shape()[1] == 2);
     std::cout << "test_tensor_basic passed\n";
+}
+
+void test_thread_pool_parallel_for() {
+    utec::parallel::ThreadPool pool(4, false);
+    std::vector<int> visitas(100000, 0);
+    pool.parallel_for(0, visitas.size(), 1000, [&](unsigned long lo, unsigned long hi) {
+        for (unsigned long i = lo; i < hi; ++i) visitas[i]++;
+    });
+    for (int v : visitas) assert(v == 1);
+
+    // parallel_for anidado no debe bloquearse
+    std::atomic<unsigned long> total{0};
+    pool.parallel_for(0, 8, 1, [&](unsigned long lo, unsigned long hi) {
+        for (unsigned long i = lo; i < hi; ++i)
+            pool.parallel_for(0, 1000, 10, [&](unsigned long a, unsigned long b) {
+                total += b - a;
+            });
+    });
+    assert(total == 8000);
+
+    bool lanzada = false;
+    try {
+        pool.parallel_for(0, 100, 1, [](unsigned long lo, unsigned long hi) {
+            if (lo <= 50 && 50 < hi) throw TensorError("fallo en tarea");
+        });
+    } catch (const TensorError&) {
+        lanzada = true;
+    }
+    assert(lanzada);
+    std::cout << "test_thread_pool_parallel_for passed\n";
+}
+
+void test_matrix_product_parallel() {
+    const unsigned long M = 96, K = 80, N = 72;
+    Tensor<double, 2> A(M, K), B(K, N);
+    for (unsigned long i = 0; i < M; ++i)
+        for (unsigned long k = 0; k < K; ++k)
+            A(i, k) = double((i * 3 + k) % 7) - 3.0;
+    for (unsigned long k = 0; k < K; ++k)
+        for (unsigned long j = 0; j < N; ++j)
+            B(k, j) = double((k + j * 5) % 11) - 5.0;
+
+    auto R = matrix_product(A, B);
+    for (unsigned long i = 0; i < M; ++i) {
+        for (unsigned long j = 0; j < N; ++j) {
+            double esperado = 0;
+            for (unsigned long k = 0; k < K; ++k)
+                esperado += A(i, k) * B(k, j);
+            assert(R(i, j) == esperado);
+        }
+    }
+
+    auto C = (A * 2.0).apply([](double v) { return v + 1.0; });
+    assert(C(5, 7) == A(5, 7) * 2.0 + 1.0);
+    std::cout << "test_matrix_product_parallel passed\n";
+}
+
+void test_broadcasting_and_reductions() {
+    Tensor<float, 2> A(3, 4), fila(1, 4), col(3, 1);
+    for (unsigned long i = 0; i < 3; ++i)
+        for (unsigned long j = 0; j < 4; ++j)
+            A(i, j) = float(i * 4 + j);
+    fila = {10, 20, 30, 40};
+    col = {1, 2, 3};
+
+    auto B = A + fila;
+    assert(B(2, 3) == 11.0f + 40.0f);
+    auto C = col * fila;
+    assert(C.shape()[0] == 3 && C.shape()[1] == 4 && C(1, 2) == 60.0f);
+    A -= col;
+    assert(A(2, 0) == 5.0f);
+
+    bool lanzada = false;
+    try {
+        Tensor<float, 2> X(3, 2), Z(2, 3);
+        auto R = X + Z;
+    } catch (const TensorError&) {
+        lanzada = true;
+    }
+    assert(lanzada);
+
+    Tensor<int, 3> T3(2, 3, 4);
+    for (unsigned long i = 0; i < 2; ++i)
+        for (unsigned long j = 0; j < 3; ++j)
+            for (unsigned long k = 0; k < 4; ++k)
+                T3(i, j, k) = int(i * 100 + j * 10 + k);
+    auto s1 = T3.sum(1);
+    assert(s1.shape()[1] == 1 && s1(1, 0, 2) == 3 * 102 + 30);
+    auto m2 = T3.max(2);
+    assert(m2(0, 2, 0) == 23);
+    auto m0 = T3.mean(0);
+    assert(m0(0, 1, 1) == 61);
+    auto r = T3 - T3.max(2);
+    assert(r(1, 1, 3) == 0 && r(1, 1, 0) == -3);
+    std::cout << "test_broadcasting_and_reductions passed\n";
+}
+
+void test_counter_rng_reproducible() {
+    CounterRNG rng(42, 3);
+    std::vector<float> a(10001), b(10001);
+    rng.fill_normal(a.data(), a.size(), 0.0f, 1.0f);
+    // Mismo resultado generando por elemento y desde un offset arbitrario
+    for (unsigned long i = 0; i < a.size(); i += 997)
+        assert(a[i] == rng.normal(i));
+    rng.fill_normal(b.data() + 7, b.size() - 7, 0.0f, 1.0f, 7);
+    for (unsigned long i = 7; i < a.size(); ++i)
+        assert(a[i] == b[i]);
+
+    double media = 0, var = 0;
+    for (float v : a) media += v;
+    media /= a.size();
+    for (float v : a) var += (v - media) * (v - media);
+    var /= a.size();
+    assert(std::abs(media) < 0.05 && std::abs(var - 1.0) < 0.05);
+
+    CounterRNG otro(42, 4);
+    assert(otro.bits(0) != rng.bits(0));
+    float u = rng.uniform(123);
+    assert(u >= 0.0f && u < 1.0f);
+    std::cout << "test_counter_rng_reproducible passed\n";
 }
\ No newline at end of file